@@ -0,0 +1,35 @@
+#ifndef ACTIONSOURCE_H
+#define ACTIONSOURCE_H
+
+#include <vector>
+#include "Map.h"
+#include "GameIO.h"
+
+class Creature;
+class Player;
+
+// 玩家的行动来源：每回合给出一个按键（W/A/S/D 移动，Q 退出）
+// 真人玩家用 KeyboardSource，自动测试用 Bot
+class ActionSource {
+public:
+    virtual ~ActionSource() = default;
+    virtual char nextAction(Map& map, const Player& self, const std::vector<Creature*>& creatures) = 0;
+};
+
+// 从输入端点读取按键
+class KeyboardSource : public ActionSource {
+private:
+    GameIO& io;
+
+public:
+    explicit KeyboardSource(GameIO& endpoint) : io(endpoint) {}
+
+    char nextAction(Map& /*map*/, const Player& /*self*/, const std::vector<Creature*>& /*creatures*/) override {
+        char input = io.get();
+        // 连接断开时按退出处理
+        if (!io.isOpen()) return 'Q';
+        return input;
+    }
+};
+
+#endif // ACTIONSOURCE_H
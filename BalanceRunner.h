@@ -0,0 +1,123 @@
+#ifndef BALANCERUNNER_H
+#define BALANCERUNNER_H
+
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include "Game.h"
+#include "ThreadPool.h"
+
+// 数值平衡批量模拟：每个 (模式, 难度) 组合各跑 N 局，由 Bot 自动游玩
+// 每局游戏有自己的 Game / Rng / 日志，彼此完全独立，因此可以铺满所有 CPU 核心
+// 种子由 (基础种子, 模式, 难度, 局号) 确定，同样的参数总是得到同样的统计结果
+class BalanceRunner {
+private:
+    struct Job {
+        int mode;
+        int difficulty;
+        uint64_t seed;
+    };
+
+    // 某一层的累计数据
+    struct LevelStats {
+        int reached = 0;   // 有多少局打到了这一层
+        int deaths = 0;    // 有多少局死在这一层
+        long turns = 0;
+        long damage = 0;
+        long kills = 0;
+    };
+
+    int gamesPerConfig;
+    int endlessLevelCap;
+    uint64_t baseSeed;
+
+    static uint64_t mixSeed(uint64_t base, int mode, int diff, int game) {
+        Rng mixer(base ^ (static_cast<uint64_t>(mode) << 48) ^ (static_cast<uint64_t>(diff) << 40)
+                  ^ static_cast<uint64_t>(game));
+        return mixer.next();
+    }
+
+    void report(std::ostream& os, int mode, int diff, const std::vector<RunResult>& runs) const {
+        int wins = 0, deaths = 0, timeouts = 0;
+        long levels = 0;
+        std::vector<LevelStats> perLevel;
+        for (const auto& r : runs) {
+            wins += r.won;
+            deaths += r.died;
+            timeouts += r.timedOut;
+            levels += r.levelsCleared;
+            // 按层号累计：同一层去过多次时回合、伤害、击杀都算进这一层，但"到达"只算一次
+            std::vector<bool> counted;
+            for (size_t v = 0; v < r.levelVisits.size(); ++v) {
+                const LevelVisit& visit = r.levelVisits[v];
+                size_t i = static_cast<size_t>(visit.level - 1);
+                if (perLevel.size() <= i) perLevel.resize(i + 1);
+                if (counted.size() <= i) counted.resize(i + 1, false);
+                LevelStats& ls = perLevel[i];
+                if (!counted[i]) {
+                    ls.reached++;
+                    counted[i] = true;
+                }
+                ls.turns += visit.turns;
+                ls.damage += visit.damage;
+                ls.kills += visit.kills;
+                if (r.died && v + 1 == r.levelVisits.size()) ls.deaths++; // 死在最后停留的那一层
+            }
+        }
+
+        int n = static_cast<int>(runs.size());
+        os << "== " << (mode == MODE_STORY ? "剧情" : "无尽") << "模式 | 难度 " << diff
+           << " | " << n << " 局 ==" << std::endl;
+        os << std::fixed << std::setprecision(1)
+           << "胜率 " << 100.0 * wins / n << "% | 死亡 " << 100.0 * deaths / n
+           << "% | 超时 " << 100.0 * timeouts / n << "% | 平均通过层数 "
+           << static_cast<double>(levels) / n << std::endl;
+        os << "  层   到达   死亡率   平均回合   平均受伤   平均击杀" << std::endl;
+        for (size_t i = 0; i < perLevel.size(); ++i) {
+            const LevelStats& ls = perLevel[i];
+            if (ls.reached == 0) continue;
+            os << std::setw(4) << i + 1 << std::setw(7) << ls.reached
+               << std::setw(8) << 100.0 * ls.deaths / ls.reached << "%"
+               << std::setw(11) << static_cast<double>(ls.turns) / ls.reached
+               << std::setw(11) << static_cast<double>(ls.damage) / ls.reached
+               << std::setw(11) << static_cast<double>(ls.kills) / ls.reached << std::endl;
+        }
+        os << std::endl;
+    }
+
+public:
+    BalanceRunner(int games, int levelCap, uint64_t seed)
+        : gamesPerConfig(games > 0 ? games : 1), endlessLevelCap(levelCap > 0 ? levelCap : 1), baseSeed(seed) {}
+
+    void run(std::ostream& os, ThreadPool& pool = ThreadPool::shared()) {
+        std::vector<Job> jobs;
+        for (int mode : {MODE_STORY, MODE_INFINITE}) {
+            for (int diff = 1; diff <= 3; ++diff) {
+                for (int g = 0; g < gamesPerConfig; ++g) {
+                    jobs.push_back({mode, diff, mixSeed(baseSeed, mode, diff, g)});
+                }
+            }
+        }
+
+        // 每局结果写进自己的下标，不需要加锁
+        std::vector<RunResult> results(jobs.size());
+        pool.parallelFor(static_cast<int>(jobs.size()), 1, [&](int i) {
+            NullIO headless;
+            Game game(headless);
+            game.setSeed(jobs[i].seed);
+            results[i] = game.runBot(jobs[i].mode, jobs[i].difficulty,
+                                     jobs[i].mode == MODE_INFINITE ? endlessLevelCap : 0);
+        });
+
+        size_t begin = 0;
+        while (begin < jobs.size()) {
+            size_t end = begin + gamesPerConfig;
+            std::vector<RunResult> group(results.begin() + begin, results.begin() + end);
+            report(os, jobs[begin].mode, jobs[begin].difficulty, group);
+            begin = end;
+        }
+    }
+};
+
+#endif // BALANCERUNNER_H
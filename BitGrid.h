@@ -0,0 +1,162 @@
+#ifndef BITGRID_H
+#define BITGRID_H
+
+#include <cstdint>
+#include <vector>
+
+// 按位压缩的二维布尔网格：每行占若干个 64 位字，第 x 列在第 x / 64 个字的第 x % 64 位
+// 整行可以按字做位运算（移位、与、或），一条指令同时处理 64 个格子
+// 每行最后一个字里超出宽度的位始终保持为 0
+class BitGrid {
+private:
+    int width = 0;
+    int height = 0;
+    int words = 0; // 每行的字数
+    std::vector<uint64_t> bits;
+
+public:
+    BitGrid() = default;
+    BitGrid(int w, int h) { resize(w, h); }
+
+    // 改变尺寸并全部清零
+    void resize(int w, int h) {
+        width = w;
+        height = h;
+        words = (w + 63) / 64;
+        bits.assign(static_cast<size_t>(words) * h, 0);
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getWordsPerRow() const { return words; }
+
+    uint64_t* row(int y) { return bits.data() + static_cast<size_t>(y) * words; }
+    const uint64_t* row(int y) const { return bits.data() + static_cast<size_t>(y) * words; }
+
+    // 第 i 个字里有效位的掩码（只有最后一个字可能不满）
+    uint64_t wordMask(int i) const {
+        int valid = width - i * 64;
+        return valid >= 64 ? ~0ULL : ((1ULL << valid) - 1);
+    }
+
+    bool test(int x, int y) const {
+        return (row(y)[x >> 6] >> (x & 63)) & 1;
+    }
+
+    void set(int x, int y, bool value = true) {
+        uint64_t bit = 1ULL << (x & 63);
+        if (value) row(y)[x >> 6] |= bit;
+        else row(y)[x >> 6] &= ~bit;
+    }
+
+    void fill(bool value) {
+        for (int y = 0; y < height; ++y) {
+            uint64_t* r = row(y);
+            for (int i = 0; i < words; ++i) r[i] = value ? wordMask(i) : 0;
+        }
+    }
+};
+
+// --- 位并行的洪水填充 ---
+// 边界（frontier）不是一个个格子，而是整行的位集合：
+//   - 行内：用 Kogge-Stone 式的倍增移位，log2(64) = 6 步就能把种子沿一段连续的可走格子铺满整个字，
+//           跨字时把相邻字的最高位 / 最低位作为新种子接力
+//   - 行间：已到达的行与上一行 / 下一行的可走位相与，就是下一行的新种子
+// 自上而下、自下而上交替扫描，直到整张图没有新位被点亮
+namespace BitFill {
+
+    // 沿位号增大的方向（x 增大）填充：gen 为种子，pro 为可走格子
+    inline uint64_t fillUp(uint64_t gen, uint64_t pro) {
+        gen &= pro;
+        gen |= pro & (gen << 1);  pro &= pro << 1;
+        gen |= pro & (gen << 2);  pro &= pro << 2;
+        gen |= pro & (gen << 4);  pro &= pro << 4;
+        gen |= pro & (gen << 8);  pro &= pro << 8;
+        gen |= pro & (gen << 16); pro &= pro << 16;
+        gen |= pro & (gen << 32);
+        return gen;
+    }
+
+    // 沿位号减小的方向（x 减小）填充
+    inline uint64_t fillDown(uint64_t gen, uint64_t pro) {
+        gen &= pro;
+        gen |= pro & (gen >> 1);  pro &= pro >> 1;
+        gen |= pro & (gen >> 2);  pro &= pro >> 2;
+        gen |= pro & (gen >> 4);  pro &= pro >> 4;
+        gen |= pro & (gen >> 8);  pro &= pro >> 8;
+        gen |= pro & (gen >> 16); pro &= pro >> 16;
+        gen |= pro & (gen >> 32);
+        return gen;
+    }
+
+    // 把一行里的种子铺满它们所在的整段可走区间
+    inline void fillRow(uint64_t* r, const uint64_t* p, int words) {
+        for (int i = 0; i < words; ++i) {
+            uint64_t seed = r[i];
+            if (i > 0 && (r[i - 1] >> 63)) seed |= 1;
+            r[i] = fillUp(seed, p[i]);
+        }
+        for (int i = words - 1; i >= 0; --i) {
+            uint64_t seed = r[i];
+            if (i + 1 < words && (r[i + 1] & 1)) seed |= 1ULL << 63;
+            r[i] = fillDown(seed, p[i]);
+        }
+    }
+
+    // 从 (sx, sy) 出发，把 passable 中能走到的格子写入 reached
+    // 给了终点 (tx, ty) 时，终点一旦被点亮就提前返回
+    // 返回终点是否可达（没给终点时总是返回 false）
+    inline bool floodFill(const BitGrid& passable, int sx, int sy, BitGrid& reached, int tx = -1, int ty = -1) {
+        int w = passable.getWidth(), h = passable.getHeight(), words = passable.getWordsPerRow();
+        reached.resize(w, h);
+        if (sx < 0 || sx >= w || sy < 0 || sy >= h || !passable.test(sx, sy)) return false;
+        bool hasTarget = tx >= 0 && tx < w && ty >= 0 && ty < h;
+        reached.set(sx, sy);
+        fillRow(reached.row(sy), passable.row(sy), words);
+
+        bool changed = true;
+        while (changed) {
+            if (hasTarget && reached.test(tx, ty)) return true;
+            changed = false;
+            // 自上而下：每一行从上一行接收种子
+            for (int y = 1; y < h; ++y) {
+                uint64_t* r = reached.row(y);
+                const uint64_t* above = reached.row(y - 1);
+                const uint64_t* p = passable.row(y);
+                bool seeded = false;
+                for (int i = 0; i < words; ++i) {
+                    uint64_t add = above[i] & p[i] & ~r[i];
+                    if (add) {
+                        r[i] |= add;
+                        seeded = true;
+                    }
+                }
+                if (seeded) {
+                    fillRow(r, p, words);
+                    changed = true;
+                }
+            }
+            // 自下而上：每一行从下一行接收种子
+            for (int y = h - 2; y >= 0; --y) {
+                uint64_t* r = reached.row(y);
+                const uint64_t* below = reached.row(y + 1);
+                const uint64_t* p = passable.row(y);
+                bool seeded = false;
+                for (int i = 0; i < words; ++i) {
+                    uint64_t add = below[i] & p[i] & ~r[i];
+                    if (add) {
+                        r[i] |= add;
+                        seeded = true;
+                    }
+                }
+                if (seeded) {
+                    fillRow(r, p, words);
+                    changed = true;
+                }
+            }
+        }
+        return hasTarget && reached.test(tx, ty);
+    }
+}
+
+#endif // BITGRID_H
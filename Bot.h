@@ -0,0 +1,71 @@
+#ifndef BOT_H
+#define BOT_H
+
+#include <vector>
+#include <memory>
+#include "ActionSource.h"
+#include "Player.h"
+#include "Item.h"
+
+// 自动玩家：代替键盘给出行动，用于无人值守地批量跑完整的剧情 / 无尽流程
+// 策略很朴素：
+//   1. 血量低于一半时去喝最近的药水
+//   2. 地图上有圣剑就先去拿
+//   3. 否则沿最短路走向出口 (width-2, height-2)
+//   下一步被怪物挡住时就攻击它（移动到怪物格子即攻击）
+class Bot : public ActionSource {
+private:
+    const std::vector<std::shared_ptr<Item>>& items;
+    Rng& rng;
+    std::vector<Point> path; // 复用的路径缓冲区
+
+    static char keyFor(Point from, Point to) {
+        if (to.y < from.y) return 'W';
+        if (to.y > from.y) return 'S';
+        if (to.x < from.x) return 'A';
+        return 'D';
+    }
+
+    // 在某类物品中找最近（按实际步数）的一个，找不到返回 -1
+    template <typename ItemType>
+    int nearest(Map& map, Point from, Point& target) {
+        int best = -1;
+        for (const auto& item : items) {
+            if (!dynamic_cast<ItemType*>(item.get())) continue;
+            // 【新增】走不到的物品（在封闭的角落里）直接跳过，不用做一次注定失败的整图寻路
+            if (!map.isConnected(from, item->getPosition())) continue;
+            int d = map.getDistance(from, item->getPosition());
+            if (d >= 0 && (best < 0 || d < best)) {
+                best = d;
+                target = item->getPosition();
+            }
+        }
+        return best;
+    }
+
+public:
+    Bot(const std::vector<std::shared_ptr<Item>>& levelItems, Rng& gameRng) : items(levelItems), rng(gameRng) {}
+
+    char nextAction(Map& map, const Player& self, const std::vector<Creature*>& /*creatures*/) override {
+        Point from = self.getPosition();
+        Point target{map.getWidth() - 2, map.getHeight() - 2};
+        Point candidate{0, 0};
+
+        if (self.getHp() * 2 < self.getMaxHp() && nearest<Potion>(map, from, candidate) >= 0) {
+            target = candidate;
+        } else if (nearest<Sword>(map, from, candidate) >= 0) {
+            target = candidate;
+        }
+
+        if (map.findPath(from, target, path, true) > 0) {
+            // 下一格有怪物也照样走过去：Player::onTurn 会把它变成攻击
+            return keyFor(from, path[0]);
+        }
+
+        // 无路可走（理论上地图生成保证了出口可达）：随便动一下
+        const char keys[4] = {'W', 'A', 'S', 'D'};
+        return keys[rng.nextInt(4)];
+    }
+};
+
+#endif // BOT_H
@@ -0,0 +1,148 @@
+#ifndef CAVEGENERATOR_H
+#define CAVEGENERATOR_H
+
+#include <vector>
+#include <utility>
+#include "BitGrid.h"
+#include "Random.h"
+
+// 洞穴风格的地图生成：随机撒墙 + 元胞自动机平滑（"4-5 规则"）
+// 地图按位压缩（1 = 墙），平滑时对整字做位运算：
+//   - 3x3 邻域的 9 个输入用移位取出（跨字的位从相邻字补进来）
+//   - 用逐位加法器把 9 个 1 位输入累加到 4 个"位平面"里，得到每个格子的墙数
+//   - "墙数 >= 5" 也只是几次与 / 或
+// 一个字一次处理 64 个格子，循环里没有分支，编译器可以继续向量化
+// 生成后保证起点 (1,1) 能走到出口 (w-2,h-2)，其余走不到的空洞会被填平
+namespace Cave {
+
+    // 把一个 1 位输入累加到 4 位计数器（s0 为最低位，最大计到 15）
+    inline void addBit(uint64_t x, uint64_t& s0, uint64_t& s1, uint64_t& s2, uint64_t& s3) {
+        uint64_t c0 = s0 & x; s0 ^= x;
+        uint64_t c1 = s1 & c0; s1 ^= c0;
+        uint64_t c2 = s2 & c1; s2 ^= c1;
+        s3 |= c2;
+    }
+
+    // 一行里第 i 个字的左 / 中 / 右邻居：返回值的第 k 位分别是格子 k-1、k、k+1
+    inline void neighbors(const uint64_t* r, int i, int words, uint64_t& left, uint64_t& mid, uint64_t& right) {
+        mid = r[i];
+        uint64_t prev = (i > 0) ? r[i - 1] : 0;
+        uint64_t next = (i + 1 < words) ? r[i + 1] : 0;
+        left = (mid << 1) | (prev >> 63);
+        right = (mid >> 1) | (next << 63);
+    }
+
+    // 四周一圈墙，超出宽度的位清零
+    inline void applyBorder(BitGrid& walls) {
+        int w = walls.getWidth(), h = walls.getHeight(), words = walls.getWordsPerRow();
+        for (int i = 0; i < words; ++i) {
+            walls.row(0)[i] = walls.wordMask(i);
+            walls.row(h - 1)[i] = walls.wordMask(i);
+        }
+        for (int y = 1; y < h - 1; ++y) {
+            uint64_t* r = walls.row(y);
+            for (int i = 0; i < words; ++i) r[i] &= walls.wordMask(i);
+            walls.set(0, y);
+            walls.set(w - 1, y);
+        }
+    }
+
+    // 起点周围一圈和出口保持畅通（与 Map::generateObstacles 的保护区一致）
+    inline void protectStartAndExit(BitGrid& walls) {
+        int w = walls.getWidth(), h = walls.getHeight();
+        for (int y = 1; y <= 2 && y < h - 1; ++y) {
+            for (int x = 1; x <= 2 && x < w - 1; ++x) walls.set(x, y, false);
+        }
+        walls.set(w - 2, h - 2, false);
+    }
+
+    // 随机撒墙：每个字用几次随机数的与 / 或组合出目标密度
+    //   r1 & (r2 | r3)      = 3/8
+    //   r1 & (r2 | r3 | r4) = 7/16
+    inline void randomFill(BitGrid& walls, bool dense, Rng& rng) {
+        for (int y = 1; y < walls.getHeight() - 1; ++y) {
+            uint64_t* r = walls.row(y);
+            for (int i = 0; i < walls.getWordsPerRow(); ++i) {
+                uint64_t any = rng.next() | rng.next();
+                if (dense) any |= rng.next();
+                r[i] = rng.next() & any;
+            }
+        }
+        applyBorder(walls);
+    }
+
+    // 平滑一步：3x3 邻域（含自己）里墙数 >= 5 的格子变成墙，否则变成空地
+    inline void smoothStep(const BitGrid& src, BitGrid& dst) {
+        int h = src.getHeight(), words = src.getWordsPerRow();
+        for (int y = 1; y < h - 1; ++y) {
+            const uint64_t* above = src.row(y - 1);
+            const uint64_t* here = src.row(y);
+            const uint64_t* below = src.row(y + 1);
+            uint64_t* out = dst.row(y);
+            for (int i = 0; i < words; ++i) {
+                uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+                uint64_t l, m, r;
+                neighbors(above, i, words, l, m, r);
+                addBit(l, s0, s1, s2, s3); addBit(m, s0, s1, s2, s3); addBit(r, s0, s1, s2, s3);
+                neighbors(here, i, words, l, m, r);
+                addBit(l, s0, s1, s2, s3); addBit(m, s0, s1, s2, s3); addBit(r, s0, s1, s2, s3);
+                neighbors(below, i, words, l, m, r);
+                addBit(l, s0, s1, s2, s3); addBit(m, s0, s1, s2, s3); addBit(r, s0, s1, s2, s3);
+                // >= 5：5/6/7 是 s2 再加上 s1 或 s0，8/9 是 s3
+                out[i] = s3 | (s2 & (s1 | s0));
+            }
+        }
+        applyBorder(dst);
+    }
+
+    // 从 (sx, sy) 出发能走到的空地（walls 为 0 的格子）
+    // 【修改】改用按位的洪水填充（BitFill），整行一起扩展
+    inline void floodFill(const BitGrid& walls, int sx, int sy, BitGrid& reached) {
+        BitGrid open(walls.getWidth(), walls.getHeight());
+        for (int y = 0; y < walls.getHeight(); ++y) {
+            const uint64_t* wr = walls.row(y);
+            uint64_t* orow = open.row(y);
+            for (int i = 0; i < walls.getWordsPerRow(); ++i) orow[i] = ~wr[i] & walls.wordMask(i);
+        }
+        BitFill::floodFill(open, sx, sy, reached);
+    }
+
+    // 从出口向起点挖一条随机折线的隧道，直到接上 reached 区域
+    // 每一步都更靠近起点，所以最多走 (w + h) 步
+    inline void carveTunnel(BitGrid& walls, BitGrid& reached, Rng& rng) {
+        int x = walls.getWidth() - 2, y = walls.getHeight() - 2;
+        while (!reached.test(x, y)) {
+            walls.set(x, y, false);
+            reached.set(x, y);
+            bool canX = x > 1, canY = y > 1;
+            if (canX && (!canY || rng.nextInt(2) == 0)) x--;
+            else y--;
+        }
+    }
+
+    // 生成一张 w x h 的洞穴，结果写入 walls（1 = 墙）
+    inline void generate(BitGrid& walls, int w, int h, int level, Rng& rng) {
+        walls.resize(w, h);
+        randomFill(walls, level >= 6, rng);
+        protectStartAndExit(walls);
+
+        BitGrid scratch(w, h);
+        for (int step = 0; step < 4; ++step) {
+            smoothStep(walls, scratch);
+            std::swap(walls, scratch);
+            protectStartAndExit(walls);
+        }
+
+        // 连通性保证：出口走不到就挖隧道；走不到的空洞全部填成墙
+        BitGrid reached;
+        floodFill(walls, 1, 1, reached);
+        if (!reached.test(w - 2, h - 2)) carveTunnel(walls, reached, rng);
+        for (int y = 1; y < h - 1; ++y) {
+            uint64_t* r = walls.row(y);
+            const uint64_t* open = reached.row(y);
+            for (int i = 0; i < walls.getWordsPerRow(); ++i) r[i] = (r[i] | ~open[i]) & walls.wordMask(i);
+        }
+    }
+}
+
+#endif // CAVEGENERATOR_H
@@ -4,6 +4,8 @@
 #include "GameObject.h"
 #include "Map.h" // 生物移动需要知道地图信息
 #include "MessageLog.h" // 日志输出
+#include "WorldSnapshot.h"
+#include "EventBus.h" // 战斗事件
 
 class Creature : public GameObject {
 protected:
@@ -18,7 +20,30 @@ public:
 
     // 纯虚函数：每个生物的回合行为不同
     // 玩家是等待输入，怪物是AI计算
-    virtual void onTurn(Map& map, std::vector<Creature*>& others) = 0;
+    // 【修改】rng 是这局游戏的随机数生成器：不再使用全局的 rand()，同一个种子可以复现同一局
+    virtual void onTurn(Map& map, std::vector<Creature*>& others, Rng& rng) = 0;
+
+    // 【新增】快照支持：种类用于恢复时重新创建对象，save/loadState 读写全部可变属性
+    virtual CreatureKind kind() const = 0;
+
+    virtual void saveState(CreatureRecord& r) const {
+        r.kind = kind();
+        r.x = static_cast<int16_t>(pos.x);
+        r.y = static_cast<int16_t>(pos.y);
+        r.hp = hp;
+        r.maxHp = maxHp;
+        r.attack = attackPower;
+        r.defense = defense;
+        r.extra[0] = r.extra[1] = 0;
+    }
+
+    virtual void loadState(const CreatureRecord& r) {
+        pos = {r.x, r.y};
+        hp = r.hp;
+        maxHp = r.maxHp;
+        attackPower = r.attack;
+        defense = r.defense;
+    }
 
     // 尝试移动逻辑：检查地图是否阻挡
     bool tryMove(int dx, int dy, const Map& map) {
@@ -35,18 +60,21 @@ public:
     }
 
     // 基础绘制实现（如果不需要特殊绘制，直接复用父类的）
-    void draw() const override {
-        GameObject::printSymbol();
+    void draw(std::ostream& os) const override {
+        GameObject::printSymbol(os);
     }
 
     // Getters
     int getHp() const { return hp; }
     int getMaxHp() const { return maxHp; }
+    int getAttackPower() const { return attackPower; }
+    int getDefense() const { return defense; }
 
     // 在类内部添加以下方法：
 
     // 接收伤害
-    void takeDamage(int amount) {
+    // 【修改】返回实际扣除的血量（供攻击事件记录）
+    int takeDamage(int amount) {
         int actualDamage = amount - defense;
         if (actualDamage < 1) actualDamage = 1; // 破防机制：最少扣1血
         
@@ -56,16 +84,21 @@ public:
         // 记录日志
         // 注意：这里简单拼接字符串，并未处理很复杂的格式
         // MessageLog::add(name + " 受到 " + std::to_string(actualDamage) + " 点伤害！");
+        return actualDamage;
     }
 
     // 攻击目标
     void attack(Creature* target) {
         // 这里可以加入命中率计算，目前必中
-        MessageLog::add(name + " 攻击了 " + target->getName() + " !");
-        target->takeDamage(attackPower);
+        // 【修改】不再直接写日志，而是投递事件，由订阅者（日志、统计……）在模拟之外处理
+        int damage = target->takeDamage(attackPower);
+        Point at = target->getPosition();
+        uint8_t self = static_cast<uint8_t>(kind());
+        uint8_t victim = static_cast<uint8_t>(target->kind());
+        EventBus::emit({GameEvent::ATTACK, self, victim, static_cast<int16_t>(at.x), static_cast<int16_t>(at.y), damage, 0});
         
         if (target->isDead()) {
-            MessageLog::add(target->getName() + " 被击败了！");
+            EventBus::emit({GameEvent::DEATH, self, victim, static_cast<int16_t>(at.x), static_cast<int16_t>(at.y), 0, 0});
             // 这里可以处理经验值获取，稍后在 Player 类完善
         }
     }
@@ -0,0 +1,276 @@
+#ifndef DRAGONSEARCH_H
+#define DRAGONSEARCH_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "Intent.h"
+
+// 巨龙的前瞻搜索（可选的 Boss AI）
+// 只看巨龙和玩家两个"棋子"：其余怪物当作这一刻不动的障碍物
+//   - 巨龙的回合取最大值（8 个方向 + 原地），玩家的回合取加权平均（WASD + 原地，偏向朝出口走）——即 expectimax
+//   - 巨龙只在偶数回合行动，搜索里同样按 moveToken 的奇偶跳过它的休息回合
+//   - 迭代加深：从 1 回合开始逐层加深，超出节点预算时放弃当前这一层，使用上一层的结果
+//     只按节点数停止、不看时钟：机器再忙，同一个种子也总是走出同一局（满预算约 3 毫秒）
+// 局面用 Zobrist 式的哈希表示（位置、血量、行动奇偶各有一个随机键，异或在一起），
+// 再异或上搜索范围内其他怪物的位置和双方的攻防：怪物挪动或玩家捡到剑之后，旧的表项自然对不上
+// 评估结果存进定长的置换表，同一局面在本回合的不同分支之间、以及下一回合都可以直接复用
+//
+// 每条巨龙有自己的 DragonSearch，decide() 在线程池上并行时也互不影响
+class DragonSearch {
+public:
+    struct Budget {
+        int maxDepth = 6;          // 最多看几个回合
+        long maxNodes = 60000;     // 节点预算：同样的局面总是得到同样的结果
+        int radius = 8;            // 离玩家太远时不搜索，直接贪心靠近
+    };
+
+private:
+    struct State {
+        Point dragon;
+        Point hero;
+        int dragonHp;
+        int heroHp;
+        int token; // 巨龙的 moveToken
+    };
+
+    struct Entry {
+        uint64_t key = 0;
+        int16_t depth = -1;
+        int8_t move = -1;   // 最佳走法（0-7 方向，8 原地）
+        float value = 0;
+    };
+
+    static const int TABLE_BITS = 14;
+    static const int TABLE_SIZE = 1 << TABLE_BITS;
+    static constexpr float EXIT_BIAS = 10.0f;
+
+    // 评估权重（从巨龙的角度看，越大越好）
+    static constexpr float HERO_HP_WEIGHT = 10.0f;   // 玩家每掉 1 点血
+    static constexpr float DRAGON_HP_WEIGHT = 6.0f;  // 自己每剩 1 点血
+    static constexpr float DISTANCE_WEIGHT = 2.0f;   // 离玩家每远一格
+    // 分出胜负时的奖惩是有限的：惩罚太大会让残血的巨龙只顾逃跑，反而比贪心追击还弱
+    static constexpr float KILL_REWARD = 200.0f;
+    static constexpr float DEATH_PENALTY = 200.0f;
+
+    // 8 个方向 + 原地（巨龙可以斜着走，与贪心逻辑一致）
+    static constexpr int DRAGON_DX[9] = {1, -1, 0, 0, 1, 1, -1, -1, 0};
+    static constexpr int DRAGON_DY[9] = {0, 0, 1, -1, 1, -1, 1, -1, 0};
+    // 玩家：WASD + 原地
+    static constexpr int HERO_DX[5] = {0, 0, -1, 1, 0};
+    static constexpr int HERO_DY[5] = {-1, 1, 0, 0, 0};
+
+    std::vector<Entry> table;
+    Budget budget;
+
+    // 本次搜索的上下文
+    const TurnSnapshot* world = nullptr;
+    int self = -1;
+    Point goal{0, 0}; // 出口
+    int dragonAttack = 0, dragonDefense = 0, heroAttack = 0, heroDefense = 0;
+    uint64_t context = 0; // 本回合不变的部分（周围怪物的位置、双方攻防）的哈希，并入每个局面的键
+    long nodes = 0;
+    bool aborted = false;
+
+    // 不存表的 Zobrist 键：由 (种类, 坐标) 经 SplitMix64 混合得到，地图再大也不需要预先生成
+    static uint64_t mix(uint64_t z) {
+        z += 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    static uint64_t zobrist(uint64_t kind, int a, int b) {
+        return mix((kind << 56) ^ (static_cast<uint64_t>(static_cast<uint32_t>(a)) << 28) ^ static_cast<uint32_t>(b));
+    }
+
+    uint64_t hashOf(const State& s) const {
+        return context ^ zobrist(1, s.dragon.x, s.dragon.y) ^ zobrist(2, s.hero.x, s.hero.y)
+             ^ zobrist(3, s.dragonHp, 0) ^ zobrist(4, s.heroHp, 0) ^ zobrist(5, s.token & 1, 0);
+    }
+
+    static int damage(int attack, int defense) {
+        int d = attack - defense;
+        return d < 1 ? 1 : d; // 与 Creature::takeDamage 一致
+    }
+
+    static int manhattan(Point a, Point b) { return std::abs(a.x - b.x) + std::abs(a.y - b.y); }
+
+    static int chebyshev(Point a, Point b) {
+        int dx = std::abs(a.x - b.x), dy = std::abs(a.y - b.y);
+        return dx > dy ? dx : dy;
+    }
+
+    // 格子能否站人：不是墙，也没有被其他怪物占据（巨龙和玩家自己的位置由 State 决定）
+    bool isOpen(int x, int y) const {
+        if (!world->map->isWalkable(x, y)) return false;
+        int other = world->occupantAt(x, y);
+        return other < 0 || other == self || other == world->heroIndex;
+    }
+
+    float evaluate(const State& s) const {
+        if (s.heroHp <= 0) return KILL_REWARD + DRAGON_HP_WEIGHT * s.dragonHp;
+        if (s.dragonHp <= 0) return -DEATH_PENALTY - HERO_HP_WEIGHT * s.heroHp;
+        return -HERO_HP_WEIGHT * s.heroHp + DRAGON_HP_WEIGHT * s.dragonHp - DISTANCE_WEIGHT * chebyshev(s.dragon, s.hero);
+    }
+
+    // 搜索中可能碰到的格子（巨龙和玩家各自 maxDepth + 1 格以内）里其他怪物的位置
+    uint64_t hashOccupants(Point dragon, Point hero) const {
+        int reach = budget.maxDepth + 1;
+        int x0 = (dragon.x < hero.x ? dragon.x : hero.x) - reach;
+        int x1 = (dragon.x > hero.x ? dragon.x : hero.x) + reach;
+        int y0 = (dragon.y < hero.y ? dragon.y : hero.y) - reach;
+        int y1 = (dragon.y > hero.y ? dragon.y : hero.y) + reach;
+        uint64_t h = 0;
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                int other = world->occupantAt(x, y);
+                if (other >= 0 && other != self && other != world->heroIndex) h ^= zobrist(6, x, y);
+            }
+        }
+        return h;
+    }
+
+    bool outOfBudget() {
+        if (aborted) return true;
+        if (++nodes > budget.maxNodes) aborted = true;
+        return aborted;
+    }
+
+    // 巨龙一步：返回是否合法
+    bool applyDragon(const State& s, int move, State& out) const {
+        out = s;
+        out.token = s.token + 1;
+        if (move == 8) return true;
+        Point to{s.dragon.x + DRAGON_DX[move], s.dragon.y + DRAGON_DY[move]};
+        if (to == s.hero) {
+            out.heroHp -= damage(dragonAttack, heroDefense);
+            return true;
+        }
+        if (!isOpen(to.x, to.y)) return false;
+        out.dragon = to;
+        return true;
+    }
+
+    // 玩家一步：撞墙 / 撞到其他怪物时原地不动
+    void applyHero(const State& s, int move, State& out) const {
+        out = s;
+        if (move == 4) return;
+        Point to{s.hero.x + HERO_DX[move], s.hero.y + HERO_DY[move]};
+        if (to == s.dragon) {
+            out.dragonHp -= damage(heroAttack, dragonDefense);
+            return;
+        }
+        if (isOpen(to.x, to.y)) out.hero = to;
+    }
+
+    // 玩家的回合：按走法的概率加权平均
+    // 玩家多半是朝出口（右下角）走的：靠近出口的走法权重为 EXIT_BIAS，其余为 1
+    float chanceNode(const State& s, int depth) {
+        if (depth == 0 || s.heroHp <= 0 || s.dragonHp <= 0) return evaluate(s);
+        int here = manhattan(s.hero, goal);
+        float sum = 0, weights = 0;
+        for (int m = 0; m < 5; ++m) {
+            State next;
+            applyHero(s, m, next);
+            Point to{s.hero.x + HERO_DX[m], s.hero.y + HERO_DY[m]};
+            float w = manhattan(to, goal) < here ? EXIT_BIAS : 1.0f;
+            sum += w * dragonNode(next, depth);
+            weights += w;
+            if (aborted) return 0;
+        }
+        return sum / weights;
+    }
+
+    // 巨龙的回合（休息回合只有"原地"一种走法）
+    float dragonNode(const State& s, int depth, int* bestMove = nullptr) {
+        if (outOfBudget()) return 0;
+        if (s.heroHp <= 0 || s.dragonHp <= 0) return evaluate(s);
+
+        uint64_t key = hashOf(s);
+        Entry& slot = table[key & (TABLE_SIZE - 1)];
+        if (!bestMove && slot.key == key && slot.depth >= depth) return slot.value;
+
+        bool active = (s.token + 1) % 2 == 0;
+        float best = -1e30f;
+        int bestIndex = 8;
+        // 上次在这个局面找到的最佳走法先试（迭代加深时让结果更稳定）
+        int first = (slot.key == key && slot.move >= 0) ? slot.move : 8;
+        for (int i = -1; i < 9; ++i) {
+            int move = (i < 0) ? first : i;
+            if (i == first) continue;
+            if (!active && move != 8) continue;
+            State next;
+            if (!applyDragon(s, move, next)) continue;
+            float value = chanceNode(next, depth - 1);
+            if (aborted) return 0;
+            if (value > best) {
+                best = value;
+                bestIndex = move;
+            }
+        }
+
+        if (slot.key != key || depth >= slot.depth) {
+            slot.key = key;
+            slot.depth = static_cast<int16_t>(depth);
+            slot.move = static_cast<int8_t>(bestIndex);
+            slot.value = best;
+        }
+        if (bestMove) *bestMove = bestIndex;
+        return best;
+    }
+
+public:
+    DragonSearch() : table(TABLE_SIZE) {}
+    explicit DragonSearch(const Budget& b) : table(TABLE_SIZE), budget(b) {}
+
+    // 给出巨龙本回合的意图；距离太远、不是行动回合或预算不够搜完一层时返回 false，由调用者走贪心逻辑
+    bool choose(const TurnSnapshot& snapshot, int selfIndex, int moveToken,
+                int atk, int def, int hp, Intent& intent) {
+        if (snapshot.heroIndex < 0 || (moveToken + 1) % 2 != 0) return false;
+        const Creature* hero = snapshot.creatures[snapshot.heroIndex];
+        Point dragonPos = snapshot.positions[selfIndex];
+        Point heroPos = snapshot.positions[snapshot.heroIndex];
+        if (chebyshev(dragonPos, heroPos) > budget.radius) return false;
+        // 走不到玩家身边（隔着墙）时搜索没有意义；贪心逻辑还能斜着穿过墙角去试
+        if (!snapshot.map->isConnected(dragonPos, heroPos)) return false;
+
+        world = &snapshot;
+        self = selfIndex;
+        goal = {snapshot.map->getWidth() - 2, snapshot.map->getHeight() - 2};
+        dragonAttack = atk;
+        dragonDefense = def;
+        heroAttack = hero->getAttackPower();
+        heroDefense = hero->getDefense();
+        State root{dragonPos, heroPos, hp, hero->getHp(), moveToken};
+        // 伤害模型变了（例如玩家捡到了剑），上一回合存下的评估也不能再用
+        context = hashOccupants(dragonPos, heroPos)
+                ^ zobrist(7, dragonAttack, dragonDefense) ^ zobrist(8, heroAttack, heroDefense);
+
+        nodes = 0;
+        aborted = false;
+
+        int chosen = -1;
+        for (int depth = 1; depth <= budget.maxDepth; ++depth) {
+            int move = 8;
+            dragonNode(root, depth, &move);
+            if (aborted) break; // 这一层没搜完，沿用上一层的结果
+            chosen = move;
+        }
+        if (chosen < 0) return false; // 连 1 回合都没搜完：交给贪心追击
+
+        intent = Intent{};
+        if (chosen == 8) return true;
+        Point to{dragonPos.x + DRAGON_DX[chosen], dragonPos.y + DRAGON_DY[chosen]};
+        intent.target = to;
+        if (to == heroPos) {
+            intent.type = Intent::ATTACK;
+            intent.targetIndex = snapshot.heroIndex;
+        } else {
+            intent.type = Intent::MOVE;
+        }
+        return true;
+    }
+};
+
+#endif // DRAGONSEARCH_H
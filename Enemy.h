@@ -2,17 +2,41 @@
 #define ENEMY_H
 
 #include "Creature.h"
-#include <cstdlib> // for rand()
+#include "Intent.h"
+#include "DragonSearch.h"
+#include <memory>
 
 // 敌人基类
+// 【修改】怪物的回合拆成两个阶段：
+//   1. decide()：只读快照，给出意图（可以在多个线程上并行执行）
+//   2. applyIntent()：由 EnemyAI 按固定顺序依次结算（只在主线程执行）
 class Enemy : public Creature {
 public:
     Enemy(int x, int y, std::string sym, std::string n, int hp, int atk, int def, std::string c)
         : Creature(x, y, sym, n, hp, atk, def, c) {}
-        
-    // 后面会由具体子类覆盖，这里提供默认行为
-    void onTurn(Map& map, std::vector<Creature*>& others) override {
-        // 默认空AI，不动
+
+    // 决策：self 是自己在快照中的下标。默认空AI，不动
+    virtual Intent decide(const TurnSnapshot& /*world*/, int /*self*/) const {
+        return Intent{};
+    }
+
+    // 结算：意图已经由 EnemyAI 检查过，这里直接执行
+    virtual void applyIntent(const Intent& intent, Creature* target) {
+        if (intent.type == Intent::MOVE) {
+            pos = intent.target;
+        } else if (intent.type == Intent::ATTACK && target) {
+            attack(target);
+        }
+    }
+
+    // 单独行动时（不经过 EnemyAI）也走同一套 决策 -> 结算 流程
+    void onTurn(Map& map, std::vector<Creature*>& others, Rng& rng) override {
+        TurnSnapshot world;
+        world.build(map, others, rng);
+        int self = world.indexOf(this);
+        if (self < 0) return;
+        Intent intent = decide(world, self);
+        applyIntent(intent, intent.type == Intent::ATTACK ? world.creatures[intent.targetIndex] : nullptr);
     }
 };
 
@@ -23,9 +47,12 @@ public:
         // 这里的参数：符号 's', 名字 "Slime", HP 20, 攻 5, 防 0, 颜色 青色
         : Enemy(x, y, "s", "Slime", 20, 5, 0, Color::CYAN) {}
 
-    void onTurn(Map& map, std::vector<Creature*>& others) override {
-        // 简单的随机 AI
-        int dir = rand() % 4;
+    CreatureKind kind() const override { return CreatureKind::SLIME; }
+
+    Intent decide(const TurnSnapshot& world, int self) const override {
+        Intent intent;
+        // 简单的随机 AI（随机数来自快照里的种子，保证并行时结果可复现）
+        int dir = world.seeds[self] % 4;
         int dx = 0, dy = 0;
         switch(dir) {
             case 0: dy = -1; break; // 上
@@ -39,25 +66,24 @@ public:
         int targetY = pos.y + dy;
 
         // 1. 检查是否撞墙
-        if (!map.isWalkable(targetX, targetY)) return;
+        if (!world.map->isWalkable(targetX, targetY)) return intent;
 
         // 2. 检查是否撞到玩家或其他怪物
-        // 哪怕是简单的史莱姆，我们也要遍历 others 列表看看目标点有没有人
-        for (auto* other : others) {
-            if (other == this) continue; // 跳过自己
-            if (other->getPosition().x == targetX && other->getPosition().y == targetY) {
-                // 如果撞到的是 Hero (玩家)，则攻击！
-                // 这里用简单的名称判断，严谨点应该用 dynamic_cast 或 type tag
-                if (other->getName() == "Hero") {
-                    attack(other);
-                }
-                return; // 撞到人就停下，不移动
+        int other = world.occupantAt(targetX, targetY);
+        if (other >= 0) {
+            // 如果撞到的是 Hero (玩家)，则攻击！
+            if (other == world.heroIndex) {
+                intent.type = Intent::ATTACK;
+                intent.target = {targetX, targetY};
+                intent.targetIndex = other;
             }
+            return intent; // 撞到人就停下，不移动
         }
 
         // 3. 没人没墙，移动
-        pos.x = targetX;
-        pos.y = targetY;
+        intent.type = Intent::MOVE;
+        intent.target = {targetX, targetY};
+        return intent;
     }
 };
 
@@ -65,67 +91,92 @@ public:
 class Dragon : public Enemy {
 private:
     int moveToken; // 用于计算回合数
+    // 【新增】前瞻搜索（置换表随巨龙保留，跨回合复用）；为空时使用原来的贪心逻辑
+    // const 的 decide() 会写它的置换表，所以是 mutable：它只属于这条巨龙，并行决策时不会被别的线程碰到
+    mutable std::unique_ptr<DragonSearch> search;
 
 public:
     Dragon(int x, int y) 
         // 龙：符号 'D', 血厚攻高，红色
         : Enemy(x, y, "D", "Dragon", 50, 15, 5, Color::RED), moveToken(0) {}
 
-    void onTurn(Map& map, std::vector<Creature*>& others) override {
+    CreatureKind kind() const override { return CreatureKind::DRAGON; }
+
+    // 【新增】开启 / 关闭前瞻搜索（例如"受苦"难度）
+    void enableLookahead(bool on) {
+        if (on && !search) search = std::make_unique<DragonSearch>();
+        else if (!on) search.reset();
+    }
+    bool hasLookahead() const { return search != nullptr; }
+
+    void saveState(CreatureRecord& r) const override {
+        Enemy::saveState(r);
+        r.extra[0] = moveToken;
+        r.extra[1] = hasLookahead() ? 1 : 0;
+    }
+
+    void loadState(const CreatureRecord& r) override {
+        Enemy::loadState(r);
+        moveToken = r.extra[0];
+        enableLookahead(r.extra[1] != 0);
+    }
+
+    Intent decide(const TurnSnapshot& world, int self) const override {
+        Intent intent;
         // --- 1. 速度削弱逻辑 ---
-        moveToken++;
+        // moveToken 在结算阶段才加一，所以这里看的是"加一之后"的奇偶
         // 只有偶数回合才行动 (0, 2, 4...)，奇数回合休息
         // 这意味着巨龙的速度是玩家的 0.5 倍
-        if (moveToken % 2 != 0) {
-            // 可以选择性加一句日志让玩家知道龙在休息，或者什么都不做
-            return; 
-        }
+        if ((moveToken + 1) % 2 != 0) return intent;
+
+        // 【新增】开启了前瞻搜索且玩家就在附近：向前看几个回合再决定
+        if (search && search->choose(world, self, moveToken, attackPower, defense, hp, intent)) return intent;
 
         // --- 以下是之前的智能寻路逻辑，保持不变 ---
         
         // 1. 寻找玩家
-        Creature* player = nullptr;
-        for (auto* c : others) {
-            if (c->getName() == "Hero") {
-                player = c;
-                break;
-            }
-        }
-        if (!player) return;
+        if (world.heroIndex < 0) return intent;
+        Point target = world.positions[world.heroIndex];
 
         // 2. 计算理想方向
         int dx = 0, dy = 0;
-        if (pos.x < player->getPosition().x) dx = 1;
-        else if (pos.x > player->getPosition().x) dx = -1;
+        if (pos.x < target.x) dx = 1;
+        else if (pos.x > target.x) dx = -1;
         
-        if (pos.y < player->getPosition().y) dy = 1;
-        else if (pos.y > player->getPosition().y) dy = -1;
+        if (pos.y < target.y) dy = 1;
+        else if (pos.y > target.y) dy = -1;
 
-        // 3. 智能移动尝试 (复用之前的 lambda)
+        // 3. 智能移动尝试
         auto tryMove = [&](int tryDx, int tryDy) -> bool {
             if (tryDx == 0 && tryDy == 0) return false;
             int targetX = pos.x + tryDx;
             int targetY = pos.y + tryDy;
-            if (!map.isWalkable(targetX, targetY)) return false;
-            for (auto* other : others) {
-                if (other == this) continue;
-                if (other->getPosition().x == targetX && other->getPosition().y == targetY) {
-                    if (other->getName() == "Hero") {
-                        attack(other);
-                        MessageLog::add(Color::RED + "巨龙喷出了烈焰！" + Color::RESET);
-                        return true; 
-                    }
-                    return false; 
-                }
+            if (!world.map->isWalkable(targetX, targetY)) return false;
+            int other = world.occupantAt(targetX, targetY);
+            if (other >= 0) {
+                if (other != world.heroIndex) return false;
+                intent.type = Intent::ATTACK;
+                intent.targetIndex = other;
+            } else {
+                intent.type = Intent::MOVE;
             }
-            pos.x = targetX;
-            pos.y = targetY;
+            intent.target = {targetX, targetY};
             return true;
         };
 
-        if (tryMove(dx, dy)) return;
-        if (dx != 0 && tryMove(dx, 0)) return;
-        if (dy != 0 && tryMove(0, dy)) return;
+        if (tryMove(dx, dy)) return intent;
+        if (dx != 0 && tryMove(dx, 0)) return intent;
+        if (dy != 0 && tryMove(0, dy)) return intent;
+        return intent;
+    }
+
+    void applyIntent(const Intent& intent, Creature* target) override {
+        moveToken++;
+        Enemy::applyIntent(intent, target);
+        if (intent.type == Intent::ATTACK && target) {
+            EventBus::emit({GameEvent::DRAGON_BREATH, static_cast<uint8_t>(CreatureKind::DRAGON), static_cast<uint8_t>(target->kind()),
+                            static_cast<int16_t>(intent.target.x), static_cast<int16_t>(intent.target.y), 0, 0});
+        }
     }
 };
 
@@ -0,0 +1,79 @@
+#ifndef ENEMYAI_H
+#define ENEMYAI_H
+
+#include <vector>
+#include "Enemy.h"
+#include "Intent.h"
+#include "ThreadPool.h"
+
+// 怪物回合调度：
+//   1. 拍摄只读快照
+//   2. 决策阶段：每个怪物根据快照给出意图，怪物很多时在线程池上并行
+//   3. 结算阶段：按怪物列表顺序依次执行意图，先到先得，结果与线程数无关
+class EnemyAI {
+private:
+    // 怪物数量少于这个值时直接在主线程决策，线程调度的开销反而更大
+    static const int PARALLEL_THRESHOLD = 256;
+    static const int GRAIN = 64;
+
+    TurnSnapshot world;
+    std::vector<Enemy*> actors;   // 与快照下标对应，玩家和非 Enemy 为 nullptr
+    std::vector<Intent> intents;
+    ThreadPool& pool;
+
+public:
+    explicit EnemyAI(ThreadPool& p = ThreadPool::shared()) : pool(p) {}
+
+    void runTurn(const Map& map, const std::vector<Creature*>& creatures, Rng& rng) {
+        world.build(map, creatures, rng);
+        int count = static_cast<int>(world.creatures.size());
+
+        actors.assign(count, nullptr);
+        for (int i = 0; i < count; ++i) {
+            if (i != world.heroIndex) actors[i] = dynamic_cast<Enemy*>(world.creatures[i]);
+        }
+
+        // --- 决策阶段（只读） ---
+        intents.assign(count, Intent{});
+        auto decideOne = [this](int i) {
+            if (actors[i]) intents[i] = actors[i]->decide(world, i);
+        };
+        if (count >= PARALLEL_THRESHOLD) {
+            pool.parallelFor(count, GRAIN, decideOne);
+        } else {
+            for (int i = 0; i < count; ++i) decideOne(i);
+        }
+
+        // --- 结算阶段（顺序执行） ---
+        // 决策已经结束，快照的占位表可以直接当作实时占位表更新
+        for (int i = 0; i < count; ++i) {
+            Enemy* self = actors[i];
+            if (!self || self->isDead()) continue;
+
+            Intent intent = intents[i];
+            Creature* target = nullptr;
+            int cell = intent.target.y * world.width + intent.target.x;
+
+            if (intent.type == Intent::MOVE) {
+                // 目标格已被本回合先结算的怪物占据：原地等待
+                if (world.occupant[cell] >= 0) intent.type = Intent::WAIT;
+            } else if (intent.type == Intent::ATTACK) {
+                target = world.creatures[intent.targetIndex];
+                if (target->isDead() || !(target->getPosition() == intent.target)) {
+                    intent.type = Intent::WAIT;
+                    target = nullptr;
+                }
+            }
+
+            Point before = self->getPosition();
+            self->applyIntent(intent, target);
+            if (intent.type == Intent::MOVE) {
+                world.occupant[before.y * world.width + before.x] = -1;
+                world.occupant[cell] = i;
+                world.positions[i] = intent.target;
+            }
+        }
+    }
+};
+
+#endif // ENEMYAI_H
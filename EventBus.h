@@ -0,0 +1,291 @@
+#ifndef EVENTBUS_H
+#define EVENTBUS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <fstream>
+#include <type_traits>
+#include "WorldSnapshot.h"
+#include "MessageLog.h"
+#include "utils.h"
+
+// 战斗事件总线
+// 攻击、死亡、拾取、进出关卡等副作用不再在 Creature::attack 里直接拼日志字符串，
+// 而是投递一个十几字节的普通事件到无锁队列里；订阅者在模拟之外（每帧开始时）统一处理：
+//   - MessageLogSink：格式化成屏幕上的日志
+//   - CombatStats：击杀、伤害、拾取统计
+//   - FileEventLogger（可选）：交给后台线程写入文件
+// 每局游戏有自己的总线，通过线程局部的 EventBus::current() 找到（与 MessageLog 一样按线程隔离）
+
+struct GameEvent {
+    enum Type : uint8_t {
+        ATTACK,        // actor 攻击 target，amount = 实际伤害
+        DEATH,         // target 被击败
+        DRAGON_BREATH, // 巨龙的攻击附带烈焰
+        ITEM_USED,     // actor = ItemKind，amount = 恢复量 / 攻击加成
+        ITEM_DECLINED, // actor = ItemKind（例如满血时碰到药水）
+        LEVEL_START,   // amount = 层数
+        LEVEL_CLEAR    // amount = 层数
+    };
+
+    Type type;
+    uint8_t actor;   // CreatureKind（ITEM_* 为 ItemKind）
+    uint8_t target;  // CreatureKind
+    int16_t x, y;    // 发生的位置
+    int32_t amount;
+    uint32_t turn;   // 由总线在投递时填写
+};
+
+static_assert(std::is_trivially_copyable<GameEvent>::value, "事件必须是普通数据");
+
+// 单生产者 / 单消费者的无锁环形队列，容量必须是 2 的幂
+template <typename T, size_t N>
+class SpscRing {
+    static_assert((N & (N - 1)) == 0, "容量必须是 2 的幂");
+
+private:
+    T slots[N];
+    alignas(64) std::atomic<size_t> head{0}; // 消费者读取的位置
+    alignas(64) std::atomic<size_t> tail{0}; // 生产者写入的位置
+
+public:
+    // 队列满时返回 false
+    bool push(const T& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == N) return false;
+        slots[t & (N - 1)] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& out) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        out = slots[h & (N - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+};
+
+// 事件订阅者
+class EventSink {
+public:
+    virtual ~EventSink() = default;
+    virtual void onEvent(const GameEvent& e) = 0;
+};
+
+// 事件的文字描述（屏幕日志和文件日志共用）
+inline const char* creatureName(uint8_t kind) {
+    switch (static_cast<CreatureKind>(kind)) {
+        case CreatureKind::HERO: return "Hero";
+        case CreatureKind::SLIME: return "Slime";
+        case CreatureKind::DRAGON: return "Dragon";
+    }
+    return "?";
+}
+
+inline std::string describeEvent(const GameEvent& e) {
+    switch (e.type) {
+        case GameEvent::ATTACK:
+            return std::string(creatureName(e.actor)) + " 攻击了 " + creatureName(e.target) + " !";
+        case GameEvent::DEATH:
+            return std::string(creatureName(e.target)) + " 被击败了！";
+        case GameEvent::DRAGON_BREATH:
+            return "巨龙喷出了烈焰！";
+        case GameEvent::ITEM_USED:
+            if (static_cast<ItemKind>(e.actor) == ItemKind::SWORD) {
+                return "你拔出了石中剑！攻击力增加了 " + std::to_string(e.amount) + " 点!";
+            }
+            return "你喝下了药水，恢复了 " + std::to_string(e.amount) + " 点 HP!";
+        case GameEvent::ITEM_DECLINED:
+            return "你生命值是满的，现在不需要药水。";
+        case GameEvent::LEVEL_START:
+            return "进入第 " + std::to_string(e.amount) + " 层";
+        case GameEvent::LEVEL_CLEAR:
+            return "通过第 " + std::to_string(e.amount) + " 层";
+    }
+    return "";
+}
+
+class EventBus {
+private:
+    static const size_t CAPACITY = 1024;
+
+    SpscRing<GameEvent, CAPACITY> queue;
+    std::vector<EventSink*> sinks;
+    uint32_t turn = 0;
+
+    static EventBus*& currentSlot() {
+        static thread_local EventBus* bus = nullptr;
+        return bus;
+    }
+
+public:
+    // 在作用域内把 bus 设为当前线程的总线（一局游戏的 run / runBot 期间）
+    class Binding {
+    private:
+        EventBus* previous;
+
+    public:
+        explicit Binding(EventBus& bus) : previous(currentSlot()) { currentSlot() = &bus; }
+        ~Binding() { currentSlot() = previous; }
+        Binding(const Binding&) = delete;
+        Binding& operator=(const Binding&) = delete;
+    };
+
+    static EventBus* current() { return currentSlot(); }
+
+    // 投递到当前线程的总线；没有绑定总线时丢弃
+    static void emit(GameEvent e) {
+        if (EventBus* bus = current()) bus->post(e);
+    }
+
+    void subscribe(EventSink* sink) { sinks.push_back(sink); }
+    void setTurn(uint32_t t) { turn = t; }
+
+    // 队列满了（一回合里事件特别多）就先就地分发一批，绝不丢事件
+    void post(GameEvent e) {
+        e.turn = turn;
+        if (!queue.push(e)) {
+            drain();
+            queue.push(e);
+        }
+    }
+
+    // 把排队的事件依次交给所有订阅者
+    void drain() {
+        GameEvent e;
+        while (queue.pop(e)) {
+            for (auto* sink : sinks) sink->onEvent(e);
+        }
+    }
+};
+
+// 屏幕日志：与原来 Creature::attack / Item::onPickUp 里的文字一致，进出关卡不显示
+class MessageLogSink : public EventSink {
+public:
+    void onEvent(const GameEvent& e) override {
+        if (e.type == GameEvent::LEVEL_START || e.type == GameEvent::LEVEL_CLEAR) return;
+        if (e.type == GameEvent::DRAGON_BREATH) {
+            MessageLog::add(Color::RED + describeEvent(e) + Color::RESET);
+        } else {
+            MessageLog::add(describeEvent(e));
+        }
+    }
+};
+
+// 战斗统计：每层和整局的击杀、伤害、拾取
+class CombatStats : public EventSink {
+public:
+    struct Counters {
+        int kills = 0;        // 玩家击杀的怪物数
+        int damageDealt = 0;  // 玩家造成的伤害
+        int damageTaken = 0;  // 玩家受到的伤害
+        int itemsUsed = 0;
+    };
+
+    Counters level;
+    Counters total;
+
+    void onEvent(const GameEvent& e) override {
+        Counters delta;
+        switch (e.type) {
+            case GameEvent::LEVEL_START:
+                level = Counters{};
+                return;
+            case GameEvent::ATTACK:
+                if (e.actor == static_cast<uint8_t>(CreatureKind::HERO)) delta.damageDealt = e.amount;
+                if (e.target == static_cast<uint8_t>(CreatureKind::HERO)) delta.damageTaken = e.amount;
+                break;
+            case GameEvent::DEATH:
+                if (e.target != static_cast<uint8_t>(CreatureKind::HERO)) delta.kills = 1;
+                break;
+            case GameEvent::ITEM_USED:
+                delta.itemsUsed = 1;
+                break;
+            default:
+                return;
+        }
+        for (Counters* c : {&level, &total}) {
+            c->kills += delta.kills;
+            c->damageDealt += delta.damageDealt;
+            c->damageTaken += delta.damageTaken;
+            c->itemsUsed += delta.itemsUsed;
+        }
+    }
+};
+
+// 文件日志：游戏线程只把事件放进无锁队列，格式化和写文件都在后台线程
+// 后台线程太慢、队列满时丢弃事件并计数，不会拖慢游戏
+class FileEventLogger : public EventSink {
+private:
+    static const size_t CAPACITY = 4096;
+
+    SpscRing<GameEvent, CAPACITY> queue;
+    std::ofstream file;
+    std::atomic<bool> stopping{false};
+    std::atomic<long> dropped{0};
+    std::mutex mutex;                  // 只用于唤醒后台线程
+    std::condition_variable wake;
+    std::thread worker;
+
+    void loop() {
+        GameEvent e;
+        while (true) {
+            while (queue.pop(e)) {
+                file << "[T" << e.turn << "] " << describeEvent(e) << '\n';
+            }
+            file.flush();
+            if (stopping.load(std::memory_order_acquire) && queue.empty()) break;
+            std::unique_lock<std::mutex> lock(mutex);
+            // 生产者通知时不加锁，可能错过一次唤醒；超时兜底
+            wake.wait_for(lock, std::chrono::milliseconds(50));
+        }
+        long lost = dropped.load(std::memory_order_relaxed);
+        if (lost > 0) file << "(丢弃了 " << lost << " 条事件)" << std::endl;
+    }
+
+public:
+    FileEventLogger() = default;
+    FileEventLogger(const FileEventLogger&) = delete;
+    FileEventLogger& operator=(const FileEventLogger&) = delete;
+
+    ~FileEventLogger() { stop(); }
+
+    bool start(const std::string& path) {
+        file.open(path, std::ios::out | std::ios::app);
+        if (!file.is_open()) return false;
+        worker = std::thread(&FileEventLogger::loop, this);
+        return true;
+    }
+
+    // 写完队列里剩下的事件再退出
+    void stop() {
+        if (!worker.joinable()) return;
+        stopping.store(true, std::memory_order_release);
+        wake.notify_one();
+        worker.join();
+    }
+
+    void onEvent(const GameEvent& e) override {
+        if (!worker.joinable()) return;
+        if (!queue.push(e)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        wake.notify_one();
+    }
+};
+
+#endif // EVENTBUS_H
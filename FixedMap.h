@@ -0,0 +1,125 @@
+#ifndef FIXEDMAP_H
+#define FIXEDMAP_H
+
+#include <array>
+#include "Map.h"
+#include "Random.h"
+#include "ObstacleGenerator.h"
+
+// 剧情模式每一层的地图尺寸是固定公式（见 Game::initLevel）：
+//   宽 = 20 + 2 * 层数，高 = 10 + 层数
+template <int Level>
+struct StoryLevelSize {
+    static constexpr int WIDTH = 20 + Level * 2;
+    static constexpr int HEIGHT = 10 + Level;
+};
+
+// 编译期确定尺寸的地图，只用于生成阶段（撒墙 + 连通性检查）
+// - 格子存放在 std::array 里，尺寸、起点、终点、邻居偏移都是编译期常量
+// - 边框一定是墙，所以内部格子的四个邻居一定在界内：BFS 里不需要任何越界判断
+// - 编译器看得到循环次数，可以把空房间拷贝、可走判断、BFS 展开 / 向量化
+// 生成完之后用 copyTo() 写入运行时的 Map，其余逻辑不变
+template <int W, int H>
+class FixedMap {
+    static_assert(W >= 4 && H >= 4, "地图太小");
+
+public:
+    static constexpr int CELLS = W * H;
+    static constexpr int START = 1 * W + 1;
+    static constexpr int EXIT = (H - 2) * W + (W - 2);
+
+private:
+    static constexpr std::array<int, 4> NEIGHBORS = {W, -W, 1, -1};
+
+    static constexpr std::array<bool, CELLS> makeBorder() {
+        std::array<bool, CELLS> border{};
+        for (int y = 0; y < H; ++y) {
+            for (int x = 0; x < W; ++x) {
+                border[y * W + x] = (y == 0 || y == H - 1 || x == 0 || x == W - 1);
+            }
+        }
+        return border;
+    }
+
+    static constexpr std::array<char, CELLS> makeEmptyRoom() {
+        std::array<char, CELLS> room{};
+        for (int i = 0; i < CELLS; ++i) room[i] = BORDER[i] ? '#' : '.';
+        room[EXIT] = '>';
+        return room;
+    }
+
+    static constexpr std::array<bool, CELLS> BORDER = makeBorder();
+    static constexpr std::array<char, CELLS> EMPTY_ROOM = makeEmptyRoom();
+
+    std::array<char, CELLS> tiles;
+
+public:
+    FixedMap() : tiles(EMPTY_ROOM) {}
+
+    void generateDefaultMap() { tiles = EMPTY_ROOM; }
+
+    bool isWalkable(int index) const { return tiles[index] != '#'; }
+
+    // 起点到出口的 BFS；队列和访问表都是定长数组，不分配内存
+    bool hasPath() const {
+        if (!isWalkable(START) || !isWalkable(EXIT)) return false;
+
+        std::array<bool, CELLS> visited{};
+        std::array<int, CELLS> queue;
+        int head = 0, tail = 0;
+        queue[tail++] = START;
+        visited[START] = true;
+
+        while (head < tail) {
+            int curr = queue[head++];
+            if (curr == EXIT) return true;
+            for (int offset : NEIGHBORS) {
+                int next = curr + offset;
+                // 边框全是墙，walkable 的格子一定在内部，next 不会越界
+                if (!visited[next] && isWalkable(next)) {
+                    visited[next] = true;
+                    queue[tail++] = next;
+                }
+            }
+        }
+        return false;
+    }
+
+    // 与 Map::generateObstacles 调用同一份算法（ObstacleGenerator.h）：
+    // 同一个种子无论走哪条路径都生成同一张地图
+    void generateObstacles(int level, Rng& rng) {
+        Obstacles::generate(W, H, level, rng,
+            [this] { generateDefaultMap(); },
+            [this](int x, int y) { tiles[y * W + x] = '#'; },
+            [this] { return hasPath(); });
+    }
+
+    void copyTo(Map& map) const {
+        map.loadTiles(tiles.data(), W, H);
+    }
+};
+
+// 用剧情模式第 Level 层对应的特化地图生成，并写入 map
+template <int Level>
+void generateStoryLevel(Map& map, Rng& rng) {
+    FixedMap<StoryLevelSize<Level>::WIDTH, StoryLevelSize<Level>::HEIGHT> fixed;
+    fixed.generateObstacles(Level, rng);
+    fixed.copyTo(map);
+}
+
+// 运行时分派到编译期实例；不是剧情层（或尺寸对不上）时返回 false，由调用者走通用路径
+inline bool generateFixedStoryLevel(int level, Map& map, Rng& rng) {
+    using Generator = void (*)(Map&, Rng&);
+    static const Generator generators[] = {
+        nullptr,
+        &generateStoryLevel<1>, &generateStoryLevel<2>, &generateStoryLevel<3>,
+        &generateStoryLevel<4>, &generateStoryLevel<5>,
+    };
+    const int count = sizeof(generators) / sizeof(generators[0]);
+    if (level < 1 || level >= count) return false;
+    if (map.getWidth() != 20 + level * 2 || map.getHeight() != 10 + level) return false;
+    generators[level](map, rng);
+    return true;
+}
+
+#endif // FIXEDMAP_H
@@ -0,0 +1,83 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include "utils.h"
+
+// 调色板：把 Color:: 里的颜色字符串映射成 1 字节的编号，方便逐格比较和复制
+namespace Palette {
+    const int COUNT = 10;
+    // 0 号表示"不加颜色"，与原来地板格子的输出保持一致
+    inline const std::string& code(unsigned char index) {
+        static const std::string codes[COUNT] = {
+            "", Color::RESET, Color::RED, Color::GREEN, Color::YELLOW, Color::BLUE,
+            Color::MAGENTA, Color::CYAN, Color::WHITE, Color::GREY
+        };
+        return codes[index < COUNT ? index : 0];
+    }
+
+    inline unsigned char indexOf(const std::string& color) {
+        for (int i = 1; i < COUNT; ++i) {
+            if (code(i) == color) return static_cast<unsigned char>(i);
+        }
+        return 0;
+    }
+}
+
+// 画面中的一个格子
+struct FrameCell {
+    char glyph;
+    unsigned char color; // Palette 编号
+
+    bool operator==(const FrameCell& other) const {
+        return glyph == other.glyph && color == other.color;
+    }
+    bool operator!=(const FrameCell& other) const { return !(*this == other); }
+};
+
+// 一帧完整画面：地图格子 + 下方的状态栏 / 日志文字
+// 由 Map::buildFrame 填充，可以直接输出，也可以交给观战推流做差分
+struct Frame {
+    int width = 0;
+    int height = 0;
+    std::vector<FrameCell> cells;
+    std::vector<std::string> lines;
+
+    void resize(int w, int h) {
+        width = w;
+        height = h;
+        cells.resize(static_cast<size_t>(w) * h);
+    }
+
+    FrameCell& at(int x, int y) { return cells[y * width + x]; }
+    const FrameCell& at(int x, int y) const { return cells[y * width + x]; }
+
+    static void writeCell(std::ostream& os, const FrameCell& cell) {
+        if (cell.color == 0) {
+            os << cell.glyph;
+        } else {
+            os << Palette::code(cell.color) << cell.glyph << Color::RESET;
+        }
+    }
+
+    // 整帧输出（不含清屏）
+    void render(std::ostream& os) const {
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) writeCell(os, at(x, y));
+            os << '\n';
+        }
+        for (const auto& line : lines) os << line << '\n';
+        os << std::flush;
+    }
+};
+
+// 画面的接收者（例如观战推流）。publish 由游戏线程调用，必须立即返回
+class FrameSink {
+public:
+    virtual ~FrameSink() = default;
+    virtual void publish(const Frame& frame) = 0;
+};
+
+#endif // FRAME_H
@@ -10,24 +10,88 @@
 #include <fstream> 
 #include <cstdio> // 用于 remove 删除存档文件
 #include <sstream>
+#include <ctime>
 
 #include "Map.h"
+#include "FixedMap.h"
 #include "Player.h"
 #include "Enemy.h"
+#include "EnemyAI.h"
 #include "Item.h"
+#include "Bot.h"
 #include "MessageLog.h"
-#include "Input.h"
+#include "GameIO.h"
+#include "SaveWriter.h"
+#include "SaveStore.h"
+#include "MemoryStats.h"
+#include "Sequence.h"
+#include "WorldSnapshot.h"
+#include "SpawnPlanner.h"
+#include "EventBus.h"
+#include "LevelCache.h"
+#include "RenderThread.h"
+#include "Scenario.h"
 
 // 定义游戏模式常量
 const int MODE_STORY = 0;   // 剧情模式 (5关结束)
 const int MODE_INFINITE = 1; // 无尽模式
 
+// 【新增】在某一层停留一次的统计（走上楼梯再回来算两次，level 相同）
+struct LevelVisit {
+    int level = 0;
+    int turns = 0;
+    int damage = 0;  // 受到的伤害
+    int kills = 0;   // 击杀的怪物数
+};
+
+// 【新增】一局游戏的结果（机器人跑图时使用）
+struct RunResult {
+    bool won = false;        // 剧情模式通关，或无尽模式达到层数上限
+    bool died = false;
+    bool timedOut = false;   // 某一层超过回合上限（机器人卡住）
+    int levelsCleared = 0;
+    long turns = 0;
+    std::vector<LevelVisit> levelVisits; // 按时间顺序，每次离开（或死在）一层时记一条
+    std::vector<Memory::Snapshot> levelMemory; // 与 levelVisits 一一对应的内存统计（开启 trackMemory 时）
+};
+
 class Game {
 private:
     std::unique_ptr<Map> map;
     std::shared_ptr<Player> player;
     std::vector<std::shared_ptr<Creature>> enemies;
     std::vector<std::shared_ptr<Item>> items;
+    EnemyAI enemyAI; // 【新增】怪物回合调度（并行决策 + 顺序结算）
+    GameIO& io;      // 【新增】本局的输入输出端点（终端或网络连接）
+    Frame frame;     // 【新增】当前画面（复用缓冲区）
+    RenderThread renderer; // 【新增】在独立线程里把画面写到终端，慢终端只丢帧不拖慢回合
+    FrameSink* spectators = nullptr; // 【新增】观战推流（可选）
+    std::shared_ptr<SaveStore> saveStore = SaveStore::forPath("saves/saves.dat"); // 【新增】所有槽位共用的存档容器（必须比 saveWriter 活得久）
+    SaveWriter saveWriter; // 【新增】后台存档线程，关卡切换时不再等磁盘
+    Scheduler scheduler;   // 【新增】推进剧情 / 过场演出，并利用停顿执行后台任务
+    Rng rng;                      // 【新增】本局的随机数发生器（地图、刷怪、怪物 AI）
+    KeyboardSource keyboard;      // 【新增】真人玩家的行动来源
+    Bot bot;                      // 【新增】自动玩家
+    ActionSource* actionSource;   // 当前使用的行动来源
+    bool savesEnabled = true;     // 机器人跑图时不写存档
+    bool botSaves = false;        // 【新增】机器人跑图时也写存档（内存报告用）
+    bool renderOffscreen = false; // 【新增】没有终端时也把画面交给渲染线程（内存报告用）
+    int levelCap = 0;             // 无尽模式最多打到第几层（0 表示不限）
+    bool trackMemory = false;     // 【新增】每层结束时记录一次内存统计
+    long turnCount = 0;           // 本局累计回合数
+    int levelTurnCount = 0;       // 本层回合数
+    int levelDamage = 0;          // 本层玩家受到的伤害
+    bool turnLimitHit = false;
+    SpawnPlanner spawner;         // 【新增】刷怪 / 放物品的位置规划（缓冲区每层复用）
+    EventBus events;              // 【新增】本局的战斗事件总线
+    MessageLogSink logSink;       // 事件 -> 屏幕日志
+    CombatStats combatStats;      // 事件 -> 击杀 / 伤害统计
+    SnapshotRing undoHistory{32}; // 【新增】真人玩家最近 32 回合的世界快照（U 键撤销）
+    LevelCache levelCache{8};     // 【新增】最近去过的 8 层（压缩保存，可以走 '<' 回去）
+    bool wentUpstairs = false;    // 本层是因为走上 '<' 而结束的
+    bool legacyChecked = false;   // 【新增】本次运行是否已经导入过旧版的单槽位存档文件
+    PhaseTimes* profile = nullptr; // 【新增】压力测试场景：按阶段累计耗时（正常游戏为空）
+    long scenarioTurnLimit = 0;    // 【新增】压力测试场景的回合上限
     
     int currentLevel;
     int difficulty; 
@@ -48,41 +112,248 @@ private:
 
     int currentSlot; // 【新增】记录当前存档槽位 (1, 2, 3...)
 
-    // 【新增】根据槽位生成文件名
-    std::string getSaveFileName(int slot) const {
+    // 旧版本每个槽位一个文件（只有 1 - 3 号）
+    std::string getLegacySaveFileName(int slot) const {
         return "saves/savegame_" + std::to_string(slot) + ".dat";
     }
 
-    // 【新增】辅助UI：让玩家选择槽位
+    // 【新增】把旧版的 savegame_N.dat 搬进存档容器（每次运行只检查一次，导入后删除旧文件）
+    void importLegacySaves() {
+        if (legacyChecked) return;
+        legacyChecked = true;
+        for (int slot = 1; slot <= 3; ++slot) {
+            std::ifstream inFile(getLegacySaveFileName(slot), std::ios::binary);
+            if (!inFile.is_open()) continue;
+            std::stringstream buffer;
+            buffer << inFile.rdbuf();
+            inFile.close();
+            if (saveStore->contains(slot)) continue; // 容器里已经有更新的存档
+
+            SaveSlotInfo info;
+            info.slot = slot;
+            std::stringstream ss(xorCipher(buffer.str()));
+            int hp, maxHp, atk;
+            if (!(ss >> info.level >> info.difficulty >> hp >> maxHp >> atk >> info.mode)) continue; // 损坏的旧存档保持原样
+
+            std::string error;
+            if (saveStore->write(info, buffer.str(), error)) {
+                std::remove(getLegacySaveFileName(slot).c_str());
+            } else {
+                io.out() << Color::RED << "导入旧存档失败：" << error << Color::RESET << std::endl;
+            }
+        }
+    }
+
+    // 【修改】槽位数量不限：菜单只读一次存档容器的索引，显示每个槽位的层数、模式、难度和时间
     int askForSaveSlot() {
-        std::cout << "\n请选择存档槽位 (1 - 3):\n";
-        // 简单的检查文件是否存在，给玩家一点提示（可选优化）
-        for (int i = 1; i <= 3; ++i) {
-            std::ifstream f(getSaveFileName(i));
-            std::cout << i << ". 槽位 " << i;
-            if (f.good()) std::cout << " [已有存档]";
-            else std::cout << " [空]";
-            std::cout << std::endl;
+        saveWriter.waitIdle(); // 等后台写完，菜单上的状态才准确
+        importLegacySaves();
+
+        std::vector<SaveSlotInfo> slots = saveStore->list();
+        int nextFree = 1;
+        for (const auto& s : slots) {
+            if (s.slot == nextFree) nextFree++;
         }
-        std::cout << "> " << std::flush;
-        
-        char c = Input::get();
-        if (c >= '1' && c <= '3') return c - '0';
-        return 1; // 默认返回槽位 1
+
+        io.out() << "\n请选择存档槽位（输入编号后回车）:\n";
+        for (const auto& s : slots) {
+            io.out() << s.slot << ". 槽位 " << s.slot << " [第 " << s.level << " 层 | "
+                     << (s.mode == MODE_INFINITE ? "无尽" : "剧情") << " | 难度 " << s.difficulty;
+            if (s.savedAt > 0) {
+                char when[32];
+                std::time_t t = static_cast<std::time_t>(s.savedAt);
+                std::strftime(when, sizeof(when), "%Y-%m-%d %H:%M", std::localtime(&t));
+                io.out() << " | " << when;
+            }
+            io.out() << "]" << std::endl;
+        }
+        io.out() << nextFree << ". 槽位 " << nextFree << " [空]" << std::endl;
+        io.out() << "> " << std::flush;
+
+        // 逐个读入数字（按键没有回显，自己回显；支持退格），回车结束
+        std::string digits;
+        while (io.isOpen()) {
+            char c = io.get();
+            if (c >= '0' && c <= '9' && digits.size() < 6) {
+                digits += c;
+                io.out() << c << std::flush;
+            } else if ((c == '\b' || c == 127) && !digits.empty()) {
+                digits.pop_back();
+                io.out() << "\b \b" << std::flush;
+            } else if (c == '\r' || c == '\n' || digits.empty()) {
+                break; // 回车；或者第一个键就不是数字（例如无人值守端点）
+            }
+        }
+        io.clearBuffer(); // 丢掉 "\r\n" 的后半个
+        io.out() << std::endl;
+
+        int slot = digits.empty() ? 0 : std::stoi(digits);
+        return slot > 0 ? slot : 1; // 默认返回槽位 1
     }
 
 public:
-    Game() : currentLevel(1), difficulty(2), gameMode(MODE_STORY), currentSlot(1) {
-        srand(time(0));
+    // 【新增】开启观战：每次画面更新都会发布给 sink
+    void setSpectatorFeed(FrameSink* sink) { spectators = sink; }
+
+    explicit Game(GameIO& endpoint)
+        : io(endpoint), renderer(endpoint), scheduler(endpoint), rng(static_cast<uint64_t>(time(0)) ^ reinterpret_cast<uintptr_t>(this)),
+          keyboard(endpoint), bot(items, rng), actionSource(&keyboard),
+          currentLevel(1), difficulty(2), gameMode(MODE_STORY), currentSlot(1) {
+        events.subscribe(&logSink);
+        events.subscribe(&combatStats);
+    }
+
+    // 【新增】额外的事件订阅者（例如写文件的 FileEventLogger），需要在 run 之前设置
+    void addEventSink(EventSink* sink) { events.subscribe(sink); }
+
+    // 【新增】在 RunResult 里附带每层的内存统计（统计是进程级的，同时只应有一局开启）
+    void setMemoryTracking(bool on) { trackMemory = on; }
+
+    // 【新增】让机器人跑图也经过存档和渲染线程，内存报告才能统计到这两个子系统的缓冲区
+    // 存档会写进 setSaveFile 指定的容器；画面写到 io（NullIO 直接丢弃）
+    void setBotSaves(bool on) { botSaves = on; }
+    void setOffscreenRendering(bool on) { renderOffscreen = on; }
+
+    // 【新增】固定随机种子：同一个种子 + 同样的输入 = 同样的一局游戏
+    void setSeed(uint64_t seed) { rng.setState(seed); }
+
+    // 【新增】改用另一个存档容器（服务器给每个玩家一个独立的文件），需要在 run 之前设置
+    // 旧版的 savegame_N.dat 属于本地玩家，不会导入到别的容器里
+    void setSaveFile(const std::string& path) {
+        saveStore = SaveStore::forPath(path);
+        legacyChecked = true;
+    }
+
+    // 【新增】当前世界能否装进一张快照（有关卡，且没有超出快照容量）
+    bool canCapture() const {
+        if (!map || !player) return false;
+        if (map->getWidth() > WorldSnapshot::MAX_WIDTH || map->getHeight() > WorldSnapshot::MAX_HEIGHT) return false;
+        if (static_cast<int>(enemies.size()) > WorldSnapshot::MAX_CREATURES) return false;
+        return static_cast<int>(items.size()) <= WorldSnapshot::MAX_ITEMS;
+    }
+
+    // 【新增】把整个可变世界写入快照；canCapture() 为 false 时不动快照，返回 false
+    bool captureSnapshot(WorldSnapshot& s) const {
+        if (!canCapture()) return false;
+        int w = map->getWidth(), h = map->getHeight();
+
+        s.width = static_cast<int16_t>(w);
+        s.height = static_cast<int16_t>(h);
+        s.level = currentLevel;
+        s.difficulty = difficulty;
+        s.mode = gameMode;
+        s.turnCount = turnCount;
+        s.levelTurns = levelTurnCount;
+        s.levelDamage = levelDamage;
+        s.rngState = rng.getState();
+        map->storeTiles(s.tiles);
+
+        // enemies[0] 就是玩家
+        s.creatureCount = static_cast<int32_t>(enemies.size());
+        for (size_t i = 0; i < enemies.size(); ++i) enemies[i]->saveState(s.creatures[i]);
+
+        s.itemCount = static_cast<int32_t>(items.size());
+        for (size_t i = 0; i < items.size(); ++i) {
+            Point p = items[i]->getPosition();
+            s.items[i] = {items[i]->kind(), static_cast<int16_t>(p.x), static_cast<int16_t>(p.y)};
+        }
+        return true;
+    }
+
+    // 【新增】恢复到快照时的世界
+    // 生物种类和数量没变时（最常见的回滚）直接原地改写属性，不重新分配对象
+    void restoreSnapshot(const WorldSnapshot& s) {
+        {
+            Memory::Scope tag(Memory::MAP_GRID);
+            if (!map || map->getWidth() != s.width || map->getHeight() != s.height) {
+                map = std::make_unique<Map>(s.width, s.height);
+            }
+            map->loadTiles(s.tiles, s.width, s.height);
+        }
+        currentLevel = s.level;
+        difficulty = s.difficulty;
+        gameMode = s.mode;
+        turnCount = static_cast<long>(s.turnCount);
+        levelTurnCount = s.levelTurns;
+        levelDamage = s.levelDamage;
+        rng.setState(s.rngState);
+
+        Memory::Scope tag(Memory::CREATURES);
+        if (!player) initPlayer();
+        bool sameCreatures = static_cast<int>(enemies.size()) == s.creatureCount;
+        for (int i = 0; sameCreatures && i < s.creatureCount; ++i) {
+            sameCreatures = enemies[i]->kind() == s.creatures[i].kind;
+        }
+        if (!sameCreatures) {
+            enemies.clear();
+            enemies.push_back(player);
+            for (int i = 1; i < s.creatureCount; ++i) enemies.push_back(makeEnemy(s.creatures[i].kind));
+        }
+        for (int i = 0; i < s.creatureCount; ++i) enemies[i]->loadState(s.creatures[i]);
+
+        Memory::Scope itemTag(Memory::ITEMS);
+        items.clear();
+        for (int i = 0; i < s.itemCount; ++i) items.push_back(makeItem(s.items[i]));
+    }
+
+    // 【新增】无人值守跑一局：由 Bot 代替键盘，从第 1 层开始一直打到死亡、通关或层数上限
+    RunResult runBot(int mode, int diff, int maxLevel) {
+        EventBus::Binding bindEvents(events);
+        MessageLog::clear();
+        gameMode = mode;
+        difficulty = diff;
+        currentLevel = 1;
+        levelCap = maxLevel;
+        savesEnabled = botSaves;
+        actionSource = &bot;
+        initPlayer();
+        return playSession();
+    }
+
+    // 【新增】压力测试：按 config 生成一层超大 / 超挤的场景，由 Bot 跑若干回合，统计每个阶段的耗时
+    // 玩家血量设得很高，保证能跑满回合数；巨龙不开前瞻搜索，测的是基础路径
+    ScenarioReport runScenario(const ScenarioConfig& config) {
+        EventBus::Binding bindEvents(events);
+        MessageLog::clear();
+        ScenarioReport report;
+        report.config = config;
+        rng.setState(config.seed);
+        gameMode = MODE_INFINITE;
+        difficulty = 2;
+        currentLevel = 1;
+        savesEnabled = false;
+        actionSource = &bot;
+        initPlayer();
+        player->setStats(1000000, 1000000, player->getAttack());
+
+        profile = &report.times;
+        initScenarioLevel(config);
+        report.enemiesAtStart = static_cast<int>(enemies.size()) - 1;
+        report.itemsAtStart = static_cast<int>(items.size());
+
+        scenarioTurnLimit = config.turns;
+        gameLoop();
+        events.drain();
+        scenarioTurnLimit = 0;
+        profile = nullptr;
+
+        report.turns = levelTurnCount;
+        report.enemiesAtEnd = static_cast<int>(enemies.size()) - 1;
+        report.itemsAtEnd = static_cast<int>(items.size());
+        Point pPos = player->getPosition();
+        report.reachedExit = pPos.x == map->getWidth() - 2 && pPos.y == map->getHeight() - 2;
+        return report;
     }
 
     void run() {
+        EventBus::Binding bindEvents(events);
+        MessageLog::clear();
         while (true) { 
             // 1. 主菜单
             int choice = showMainMenu();
             
             if (choice == 3) {
-                std::cout << "再见，勇士！" << std::endl;
+                io.out() << "再见，勇士！" << std::endl;
                 break; 
             }
 
@@ -103,84 +374,141 @@ public:
             }
 
             // 3. 游戏局循环
-            bool sessionRunning = true;
-            while (sessionRunning) {
-                showStory();    
-                initLevel();    
-                gameLoop();     
-                
-                if (player->isDead()) {
-                    handleGameOver(); 
-                    sessionRunning = false; 
+            playSession();
+
+            // 【新增】玩家按 Q 或连接断开：直接结束
+            if (player->hasQuit()) return;
+        }
+    }
+
+private:
+    // 【新增】从当前层开始一层层打下去，直到死亡、通关、退出或达到层数上限
+    RunResult playSession() {
+        RunResult result;
+        turnCount = 0;
+        levelCache.clear();
+        int deepestCleared = currentLevel - 1; // 读档时从中间某层开始
+        bool arrivingFromBelow = false;
+        while (true) {
+            if (trackMemory) Memory::resetPeaks();
+            // 【新增】去过的楼层直接从缓存解压，不重新生成，也不再播放剧情
+            if (!enterCachedLevel(arrivingFromBelow)) {
+                if (arrivingFromBelow) {
+                    // 上一层已经被淘汰出缓存：重新生成一张，出现在出口旁边
+                    initLevel();
+                    placePlayerNear({map->getWidth() - 2, map->getHeight() - 2});
                 } else {
-                    // --- 通关判断逻辑 ---
-                    
-                    // 如果是剧情模式，且打通了第 5 关 (currentLevel == 5)
-                    if (gameMode == MODE_STORY && currentLevel >= 5) {
-                        handleVictory(); // 播放胜利结局
-                        sessionRunning = false; // 结束会话，回到主菜单
-                        // 通关后删除存档，防止玩家读档继续打第六关
-                        std::remove(getSaveFileName(currentSlot).c_str());
-                    } else {
-                        // 普通过关
-                        handleLevelComplete();
-                        saveGame(); 
-                    }
+                    // 【修改】剧情演出期间顺便在后台生成这一层的地图和怪物
+                    scheduler.runInBackground([this] { initLevel(); });
+                    scheduler.run(showStory());
                 }
             }
+            gameLoop();     
+            renderer.waitIdle(); // 之后要直接输出剧情 / 结算画面
+            events.drain();
+            result.turns = turnCount;
+            result.levelVisits.push_back({currentLevel, levelTurnCount, levelDamage, combatStats.level.kills});
+            if (trackMemory) result.levelMemory.push_back(Memory::snapshot());
+            
+            if (player->hasQuit()) return result;
+            if (turnLimitHit) {
+                result.timedOut = true;
+                return result;
+            }
+
+            if (player->isDead()) {
+                result.died = true;
+                handleGameOver(); 
+                return result;
+            }
+
+            // 【新增】走上了 '<'：这一层存进缓存，回到上一层
+            if (wentUpstairs) {
+                stashLevel();
+                currentLevel--;
+                arrivingFromBelow = true;
+                MessageLog::add(Color::YELLOW + "你沿着楼梯回到了第 " + std::to_string(currentLevel) + " 层。" + Color::RESET);
+                continue;
+            }
+            arrivingFromBelow = false;
+
+            // --- 通关判断逻辑 ---
+            // 重新走过已经通过的楼层不重复计数
+            if (currentLevel > deepestCleared) {
+                result.levelsCleared++;
+                deepestCleared = currentLevel;
+            }
+            
+            // 如果是剧情模式，且打通了第 5 关 (currentLevel == 5)
+            if (gameMode == MODE_STORY && currentLevel >= 5) {
+                result.won = true;
+                handleVictory(); // 播放胜利结局
+                // 通关后删除存档，防止玩家读档继续打第六关
+                if (savesEnabled) removeSave();
+                return result;
+            }
+
+            // 普通过关：这一层存进缓存（之后还可以走回来），存档的序列化放到过场停顿里做
+            stashLevel();
+            scheduler.runInBackground([this] { if (savesEnabled) saveGame(); });
+            scheduler.run(handleLevelComplete());
+
+            if (levelCap > 0 && currentLevel > levelCap) {
+                result.won = true;
+                return result;
+            }
         }
     }
 
-private:
     void clearScreen() {
-        #ifdef _WIN32
-            system("cls");
-        #else
-            std::cout << "\033[2J\033[1;1H";
-        #endif
+        io.clearScreen();
     }
 
-    void typewriterPrint(const std::string& text, int delayMs = 30) {
-        bool skip = false;
+    // 【修改】打字机效果改为协程：每个字符之间 co_await 停顿，不再阻塞主循环
+    Sequence typewriterPrint(std::string text, int delayMs = 30) {
+        if (!io.isInteractive()) {
+            io.out() << text << std::endl;
+            co_return;
+        }
         for (char c : text) {
-            std::cout << c << std::flush;
-            if (!skip) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
-                if (Input::hasPending()) {
-                    Input::clearBuffer(); 
-                    skip = true;
-                }
-            }
+            io.out() << c << std::flush;
+            co_await Pause{delayMs};
         }
-        std::cout << std::endl; 
+        io.out() << std::endl; 
+    }
+
+    // 【新增】单纯的停顿（可被按键跳过）
+    Sequence pause(int ms) {
+        co_await Pause{ms};
     }
 
     // --- 菜单逻辑 (包含模式选择) ---
     int showMainMenu() {
         while (true) {
             clearScreen();
-            std::cout << "========================================" << std::endl;
-            std::cout << "       地牢传说 (Dungeon Legend)        " << std::endl;
-            std::cout << "========================================" << std::endl;
-            std::cout << "1. 新的游戏 (New Game)" << std::endl;
-            std::cout << "2. 继续征程 (Load Game)" << std::endl;
-            std::cout << "3. 退出游戏 (Exit)" << std::endl;
-            std::cout << "> " << std::flush;
+            io.out() << "========================================" << std::endl;
+            io.out() << "       地牢传说 (Dungeon Legend)        " << std::endl;
+            io.out() << "========================================" << std::endl;
+            io.out() << "1. 新的游戏 (New Game)" << std::endl;
+            io.out() << "2. 继续征程 (Load Game)" << std::endl;
+            io.out() << "3. 退出游戏 (Exit)" << std::endl;
+            io.out() << "> " << std::flush;
             
-            char choice = Input::get();
+            char choice = io.get();
+            if (!io.isOpen()) return 3; // 连接已断开，当作退出
             
             if (choice == '1') {
                 // 1. 先选槽位 (为了确定往哪里存)
                 currentSlot = askForSaveSlot();
 
                 // 2. 选难度
-                std::cout << "\n请选择难度 (1:萌新 2:普通 3:受苦): " << std::flush;
-                char diff = Input::get();
+                io.out() << "\n请选择难度 (1:萌新 2:普通 3:受苦): " << std::flush;
+                char diff = io.get();
                 difficulty = (diff >= '1' && diff <= '3') ? (diff - '0') : 2;
 
                 // 3. 选模式
-                std::cout << "\n请选择模式 (1:剧情 2:无尽): " << std::flush;
-                char mode = Input::get();
+                io.out() << "\n请选择模式 (1:剧情 2:无尽): " << std::flush;
+                char mode = io.get();
                 gameMode = (mode == '2') ? MODE_INFINITE : MODE_STORY;
 
                 return 1;
@@ -195,24 +523,12 @@ private:
     }
 
     void initPlayer() {
+        Memory::Scope tag(Memory::CREATURES);
         player = std::make_shared<Player>(1, 1);
+        player->setActionSource(actionSource);
         if (difficulty == 1) player->heal(50); 
     }
 
-    Point getValidSpawnPosition() {
-        int x, y;
-        int attempts = 0;
-        do {
-            x = rand() % (map->getWidth() - 2) + 1;
-            y = rand() % (map->getHeight() - 2) + 1;
-            attempts++;
-            if (attempts > 1000) break; 
-        } while (!map->isWalkable(x, y) || 
-                 (x == 1 && y == 1) || 
-                 (x == map->getWidth()-2 && y == map->getHeight()-2));
-        return {x, y};
-    }
-
     void initLevel() {
         // 限制地图大小
         int rawW = 20 + currentLevel * 2;
@@ -220,109 +536,279 @@ private:
         int mapW = (rawW > 60) ? 60 : rawW; 
         int mapH = (rawH > 25) ? 25 : rawH;
 
-        map = std::make_unique<Map>(mapW, mapH);
-        map->generateObstacles(currentLevel);
+        {
+            Memory::Scope tag(Memory::MAP_GRID);
+            map.reset(); // 先释放上一层，统计里才看得到真实占用
+            map = std::make_unique<Map>(mapW, mapH);
+            // 【新增】剧情模式的尺寸是编译期已知的，走特化的 FixedMap 生成；无尽模式走通用路径
+            // 【新增】无尽模式每隔两层出现一次洞穴层
+            if (gameMode == MODE_INFINITE && currentLevel % 3 == 0) {
+                map->generateCave(currentLevel, rng);
+            } else if (gameMode != MODE_STORY || !generateFixedStoryLevel(currentLevel, *map, rng)) {
+                map->generateObstacles(currentLevel, rng);
+            }
+            // 【新增】第 2 层起，起点放一个回到上一层的楼梯
+            if (currentLevel > 1) map->placeUpStairs({1, 1});
+        }
+
+        EventBus::emit({GameEvent::LEVEL_START, 0, 0, 1, 1, currentLevel, 0});
 
+        Memory::Scope tag(Memory::CREATURES);
         player->setPosition(1, 1);
         enemies.clear();
         enemies.push_back(player); 
 
+        // 【修改】出生点由 SpawnPlanner 从空闲且可达的格子里无放回地抽取：
+        // 怪物之间至少隔一格，离起点至少 4 格；地图太挤时放宽，格子用完就不再刷
+        spawner.plan(*map, {1, 1}, {mapW - 2, mapH - 2}, 2, 4);
+
         // 怪物生成
         int calculatedSlimeCount = currentLevel * difficulty + 2;
         int maxSlimes = (mapW * mapH) / 10;
         int slimeCount = (calculatedSlimeCount > maxSlimes) ? maxSlimes : calculatedSlimeCount;
 
-        for(int i=0; i<slimeCount; ++i) {
-            Point p = getValidSpawnPosition();
+        Point p;
+        for(int i=0; i<slimeCount && spawner.nextMonster(rng, p); ++i) {
             enemies.push_back(std::make_shared<Slime>(p.x, p.y));
         }
 
-        if (difficulty == 3 || currentLevel >= 3) {
-             Point p = getValidSpawnPosition();
-             enemies.push_back(std::make_shared<Dragon>(p.x, p.y));
+        if ((difficulty == 3 || currentLevel >= 3) && spawner.nextMonster(rng, p)) {
+             auto dragon = std::make_shared<Dragon>(p.x, p.y);
+             dragon->enableLookahead(difficulty == 3); // 【新增】受苦难度的巨龙会向前看几步
+             enemies.push_back(dragon);
         }
 
+        Memory::Scope itemTag(Memory::ITEMS);
         items.clear();
-        Point potionPos = getValidSpawnPosition();
-        items.push_back(std::make_shared<Potion>(potionPos.x, potionPos.y));
+        if (spawner.nextFree(rng, p)) items.push_back(std::make_shared<Potion>(p.x, p.y));
         
-        if (currentLevel % 2 == 0) { 
-            Point swordPos = getValidSpawnPosition();
-            items.push_back(std::make_shared<Sword>(swordPos.x, swordPos.y));
+        if (currentLevel % 2 == 0 && spawner.nextFree(rng, p)) { 
+            items.push_back(std::make_shared<Sword>(p.x, p.y));
+        }
+    }
+
+    // 【新增】压力测试场景的地图和刷怪（不受 initLevel 的尺寸和数量上限限制）
+    void initScenarioLevel(const ScenarioConfig& config) {
+        {
+            PhaseClock clock(profile, PhaseTimes::GENERATE);
+            Memory::Scope tag(Memory::MAP_GRID);
+            map.reset();
+            map = std::make_unique<Map>(config.width, config.height);
+            map->generateScattered(config.wallDensity, rng);
+        }
+
+        PhaseClock clock(profile, PhaseTimes::SPAWN);
+        Memory::Scope tag(Memory::CREATURES);
+        player->setPosition(1, 1);
+        enemies.clear();
+        enemies.reserve(static_cast<size_t>(config.slimes) + config.dragons + 1);
+        enemies.push_back(player);
+
+        // 不留间距，离起点 2 格以外；格子用完就不再刷
+        spawner.plan(*map, {1, 1}, {config.width - 2, config.height - 2}, 1, 2);
+        Point p;
+        for (int i = 0; i < config.slimes && spawner.nextMonster(rng, p); ++i) {
+            enemies.push_back(std::make_shared<Slime>(p.x, p.y));
+        }
+        for (int i = 0; i < config.dragons && spawner.nextMonster(rng, p); ++i) {
+            enemies.push_back(std::make_shared<Dragon>(p.x, p.y));
+        }
+
+        Memory::Scope itemTag(Memory::ITEMS);
+        items.clear();
+        for (int i = 0; i < config.potions && spawner.nextFree(rng, p); ++i) items.push_back(std::make_shared<Potion>(p.x, p.y));
+        for (int i = 0; i < config.swords && spawner.nextFree(rng, p); ++i) items.push_back(std::make_shared<Sword>(p.x, p.y));
+    }
+
+    // 【新增】按种类创建一个怪物 / 物品（快照和楼层缓存恢复时使用）
+    static std::shared_ptr<Creature> makeEnemy(CreatureKind kind) {
+        if (kind == CreatureKind::DRAGON) return std::make_shared<Dragon>(0, 0);
+        return std::make_shared<Slime>(0, 0);
+    }
+
+    static std::shared_ptr<Item> makeItem(const ItemRecord& r) {
+        if (r.kind == ItemKind::SWORD) return std::make_shared<Sword>(r.x, r.y);
+        return std::make_shared<Potion>(r.x, r.y);
+    }
+
+    // 【新增】把当前楼层（地形、活着的怪物、剩下的物品）压缩进缓存
+    void stashLevel() {
+        Memory::Scope tag(Memory::MAP_GRID);
+        CachedLevel cached;
+        cached.level = currentLevel;
+        cached.compressTiles(*map);
+        for (const auto& c : enemies) {
+            if (c == player || c->isDead()) continue;
+            CreatureRecord r;
+            c->saveState(r);
+            cached.creatures.push_back(r);
+        }
+        for (const auto& i : items) {
+            Point p = i->getPosition();
+            cached.items.push_back({i->kind(), static_cast<int16_t>(p.x), static_cast<int16_t>(p.y)});
+        }
+        levelCache.put(std::move(cached));
+    }
+
+    // 【新增】从缓存恢复 currentLevel；没有缓存时返回 false
+    // 从下面上来时站在出口旁边，从上面下来时站在 '<' 上
+    bool enterCachedLevel(bool fromBelow) {
+        CachedLevel cached;
+        {
+            Memory::Scope tag(Memory::MAP_GRID);
+            if (!levelCache.take(currentLevel, cached)) return false;
+            map.reset();
+            map = std::make_unique<Map>(cached.width, cached.height);
+            cached.decompressTiles(*map);
+        }
+        EventBus::emit({GameEvent::LEVEL_START, 0, 0, 1, 1, currentLevel, 0});
+
+        Memory::Scope tag(Memory::CREATURES);
+        enemies.clear();
+        enemies.push_back(player);
+        for (const auto& r : cached.creatures) {
+            enemies.push_back(makeEnemy(r.kind));
+            enemies.back()->loadState(r);
+        }
+
+        Memory::Scope itemTag(Memory::ITEMS);
+        items.clear();
+        for (const auto& r : cached.items) items.push_back(makeItem(r));
+
+        if (fromBelow) placePlayerNear({map->getWidth() - 2, map->getHeight() - 2});
+        else placePlayerNear({1, 1});
+        return true;
+    }
+
+    // 【新增】把玩家放在 anchor 附近最近的一个空格子上（不站在出口上，不站在别的楼梯格上）
+    void placePlayerNear(Point anchor) {
+        Point exitPos{map->getWidth() - 2, map->getHeight() - 2};
+        int maxRadius = std::max(map->getWidth(), map->getHeight());
+        for (int r = 0; r < maxRadius; ++r) {
+            for (int y = anchor.y - r; y <= anchor.y + r; ++y) {
+                for (int x = anchor.x - r; x <= anchor.x + r; ++x) {
+                    if (std::max(std::abs(x - anchor.x), std::abs(y - anchor.y)) != r) continue;
+                    Point p{x, y};
+                    if (!map->isWalkable(x, y) || p == exitPos) continue;
+                    if (r > 0 && map->isUpStairs(x, y)) continue;
+                    bool occupied = false;
+                    for (const auto& c : enemies) {
+                        if (c != player && !c->isDead() && c->getPosition() == p) occupied = true;
+                    }
+                    if (occupied || !map->isConnected(p, exitPos)) continue;
+                    player->setPosition(x, y);
+                    return;
+                }
+            }
         }
+        player->setPosition(1, 1);
     }
 
-    void showStory() {
+    Sequence showStory() {
         clearScreen();
-        std::cout << Color::CYAN << "----------------------------------------" << std::endl;
+        io.out() << Color::CYAN << "----------------------------------------" << std::endl;
         std::string modeStr = (gameMode == MODE_STORY) ? " (剧情模式 5层)" : " (无尽模式)";
-        std::cout << "           第 " << currentLevel << " 层" << modeStr << std::endl;
-        std::cout << "----------------------------------------" << Color::RESET << std::endl;
+        io.out() << "           第 " << currentLevel << " 层" << modeStr << std::endl;
+        io.out() << "----------------------------------------" << Color::RESET << std::endl;
         
         if (currentLevel == 1) {
-            typewriterPrint("你踏入了阴暗的地下城，传说地牢深处藏着'虚空之心'。");
-            if (gameMode == MODE_STORY) typewriterPrint("只有打通第5层，才能彻底封印这里的邪恶。");
-            else typewriterPrint("这是一条不归路，看你能坚持多久...");
+            co_await typewriterPrint("你踏入了阴暗的地下城，传说地牢深处藏着'虚空之心'。");
+            if (gameMode == MODE_STORY) co_await typewriterPrint("只有打通第5层，才能彻底封印这里的邪恶。");
+            else co_await typewriterPrint("这是一条不归路，看你能坚持多久...");
         } else if (currentLevel == 2) {
-            typewriterPrint("空气变得更加潮湿，墙壁上渗出绿色的粘液。");
+            co_await typewriterPrint("空气变得更加潮湿，墙壁上渗出绿色的粘液。");
         } else if (currentLevel == 3) {
-            typewriterPrint("这里热得让人窒息。岩浆在地板缝隙中流动。");
-            typewriterPrint("巨龙的巢穴就在前方！");
+            co_await typewriterPrint("这里热得让人窒息。岩浆在地板缝隙中流动。");
+            co_await typewriterPrint("巨龙的巢穴就在前方！");
         } else if (currentLevel == 5 && gameMode == MODE_STORY) {
-            typewriterPrint("【最终层】");
-            typewriterPrint("你感觉到了前所未有的压迫感。");
-            typewriterPrint("这是最后的试炼，虚空之心就在前方！");
+            co_await typewriterPrint("【最终层】");
+            co_await typewriterPrint("你感觉到了前所未有的压迫感。");
+            co_await typewriterPrint("这是最后的试炼，虚空之心就在前方！");
         } else {
-            typewriterPrint("你向着无尽的深渊继续进发...");
+            co_await typewriterPrint("你向着无尽的深渊继续进发...");
         }
         
-        std::cout << Color::GREY << "\n(按任意键开始战斗...)" << Color::RESET << std::endl;
-        Input::get(); 
+        io.out() << Color::GREY << "\n(按任意键开始战斗...)" << Color::RESET << std::endl;
+        co_await WaitKey{};
     }
 
     void gameLoop() {
         bool levelRunning = true;
+        turnLimitHit = false;
+        // 【新增】机器人每层最多走这么多回合，防止卡死在某张图上
+        long turnLimit = (actionSource == &bot) ? 20L * map->getWidth() * map->getHeight() : 0;
+        if (scenarioTurnLimit > 0) turnLimit = scenarioTurnLimit;
+        levelTurnCount = 0;
+        levelDamage = 0;
+        wentUpstairs = false;
+        undoHistory.clear();
         while (levelRunning && !player->isDead()) {
-            std::vector<GameObject*> renderList;
-            for (const auto& i : items) renderList.push_back(i.get());
-            for (const auto& c : enemies) renderList.push_back(c.get());
-            map->draw(renderList);
-
-            std::cout << "LV: " << currentLevel << " | DIFF: " << difficulty;
-            if (gameMode == MODE_STORY) std::cout << " | GOAL: Level 5";
-            std::cout << std::endl;
-            
-            std::cout << player->getStatsString() << std::endl;
-            int logSize = MessageLog::getLogs().size();
-            int start = (logSize > 5) ? (logSize - 5) : 0;
-            for (int i = start; i < logSize; ++i) std::cout << MessageLog::getLogs()[i] << std::endl;
+            // 【新增】上一回合的事件在画面刷新前统一交给订阅者
+            events.drain();
+            events.setTurn(static_cast<uint32_t>(turnCount + 1));
+            reportSaveResults();
+            if (io.isInteractive() || renderOffscreen || spectators || profile) {
+                PhaseClock clock(profile, PhaseTimes::RENDER);
+                drawFrame();
+            }
 
             Point pPos = player->getPosition();
             if (pPos.x == map->getWidth() - 2 && pPos.y == map->getHeight() - 2) {
                 levelRunning = false; 
                 return;
             }
+            if (turnLimit > 0 && levelTurnCount >= turnLimit) {
+                turnLimitHit = true;
+                return;
+            }
+            // 【新增】真人玩家每回合开始前拍一张快照，按 U 可以退回去
+            // 先检查再占槽位：环形缓冲满了以后 push 会覆盖最旧的快照，拍不了就不能占
+            bool recordUndo = actionSource == &keyboard && canCapture();
+            if (recordUndo) captureSnapshot(undoHistory.push());
+            levelTurnCount++;
+            turnCount++;
 
             std::vector<Creature*> activeCreatures;
             for(const auto& c : enemies) activeCreatures.push_back(c.get());
-            player->onTurn(*map, activeCreatures);
+            {
+                PhaseClock clock(profile, PhaseTimes::PLAYER);
+                player->onTurn(*map, activeCreatures, rng);
+            }
+            if (player->hasQuit()) return;
+            if (player->takeUndoRequest()) {
+                undoTurn(recordUndo);
+                continue;
+            }
+            // 【新增】主动走上 '<' 才回到上一层（出生在楼梯上不算）
+            Point moved = player->getPosition();
+            if (!(moved == pPos) && map->isUpStairs(moved.x, moved.y)) {
+                wentUpstairs = true;
+                return;
+            }
 
-             for (auto it = items.begin(); it != items.end(); ) {
-                if ((*it)->getPosition() == player->getPosition()) {
-                    if ((*it)->onPickUp(player.get())) {
-                        it = items.erase(it); 
-                        continue; 
+            {
+                PhaseClock clock(profile, PhaseTimes::PICKUP);
+                for (auto it = items.begin(); it != items.end(); ) {
+                    if ((*it)->getPosition() == player->getPosition()) {
+                        if ((*it)->onPickUp(player.get())) {
+                            it = items.erase(it); 
+                            continue; 
+                        }
                     }
+                    ++it;
                 }
-                ++it;
             }
 
-            for (auto& c : enemies) {
-                if (c.get() != player.get() && !c->isDead()) {
-                    c->onTurn(*map, activeCreatures);
-                }
+            // 【修改】怪物回合：先并行决策，再按顺序结算
+            Memory::Scope aiTag(Memory::CREATURES);
+            int hpBefore = player->getHp();
+            {
+                PhaseClock clock(profile, PhaseTimes::AI);
+                enemyAI.runTurn(*map, activeCreatures, rng);
             }
+            levelDamage += hpBefore - player->getHp();
 
+            PhaseClock clock(profile, PhaseTimes::CLEANUP);
              enemies.erase(
                 std::remove_if(enemies.begin(), enemies.end(), 
                     [this](const std::shared_ptr<Creature>& c) {
@@ -333,44 +819,81 @@ private:
         }
     }
 
+    // 【新增】撤销：丢掉本回合开头的快照（按 U 本身不算一回合），回到上一回合开头
+    void undoTurn(bool recordedThisTurn) {
+        if (recordedThisTurn) undoHistory.pop();
+        const WorldSnapshot* previous = undoHistory.pop();
+        if (previous) {
+            restoreSnapshot(*previous);
+            MessageLog::add(Color::GREY + "【调试】时光倒流：回到本层第 " + std::to_string(levelTurnCount + 1) + " 回合" + Color::RESET);
+        } else {
+            levelTurnCount--;
+            turnCount--;
+            MessageLog::add(Color::GREY + "【调试】没有可以撤销的回合" + Color::RESET);
+        }
+    }
+
+    // 【修改】先把地图、状态栏和日志写成一帧画面，再输出（以及发给观众）
+    void drawFrame() {
+        Memory::Scope tag(Memory::RENDER);
+        std::vector<GameObject*> renderList;
+        for (const auto& i : items) renderList.push_back(i.get());
+        for (const auto& c : enemies) renderList.push_back(c.get());
+        map->buildFrame(renderList, frame);
+        frame.lines.clear();
+        std::string status = "LV: " + std::to_string(currentLevel) + " | DIFF: " + std::to_string(difficulty);
+        if (gameMode == MODE_STORY) status += " | GOAL: Level 5";
+        frame.lines.push_back(status);
+        
+        frame.lines.push_back(player->getStatsString());
+        int logSize = MessageLog::getLogs().size();
+        int start = (logSize > 5) ? (logSize - 5) : 0;
+        for (int i = start; i < logSize; ++i) frame.lines.push_back(MessageLog::getLogs()[i]);
+
+        // 【修改】交给渲染线程输出，这里不等终端
+        if (io.isInteractive() || renderOffscreen) renderer.publish(frame);
+        if (spectators) spectators->publish(frame);
+    }
+
     void handleGameOver() {
         clearScreen();
-        std::cout << Color::RED << "\n\n胜败乃兵家常事。但你的冒险到此为止了。" << Color::RESET << std::endl;
-        std::cout << "按任意键返回主菜单...";
-        Input::get(); 
+        io.out() << Color::RED << "\n\n胜败乃兵家常事。但你的冒险到此为止了。" << Color::RESET << std::endl;
+        io.out() << "按任意键返回主菜单...";
+        io.get(); 
         // 游戏结束，删除存档
-        std::remove(getSaveFileName(currentSlot).c_str());
+        if (savesEnabled) removeSave();
     }
 
     // 【新增】胜利结局处理
     void handleVictory() {
         clearScreen();
-        std::cout << Color::YELLOW << "\n\n################################################" << std::endl;
-        std::cout << "#               VICTORY!                       #" << std::endl;
-        std::cout << "#                                              #" << std::endl;
-        std::cout << "#      你成功击穿了第 5 层地牢！               #" << std::endl;
-        std::cout << "#      虚空之心被你摧毁，世界恢复了和平。      #" << std::endl;
-        std::cout << "#                                              #" << std::endl;
-        std::cout << "#           感谢游玩 地牢传说                  #" << std::endl;
-        std::cout << "################################################\n" << Color::RESET << std::endl;
+        io.out() << Color::YELLOW << "\n\n################################################" << std::endl;
+        io.out() << "#               VICTORY!                       #" << std::endl;
+        io.out() << "#                                              #" << std::endl;
+        io.out() << "#      你成功击穿了第 5 层地牢！               #" << std::endl;
+        io.out() << "#      虚空之心被你摧毁，世界恢复了和平。      #" << std::endl;
+        io.out() << "#                                              #" << std::endl;
+        io.out() << "#           感谢游玩 地牢传说                  #" << std::endl;
+        io.out() << "################################################\n" << Color::RESET << std::endl;
         
-        std::cout << "按任意键返回主菜单...";
-        Input::get(); 
-        std::remove(getSaveFileName(currentSlot).c_str());
+        io.out() << "按任意键返回主菜单...";
+        io.get(); 
+        if (savesEnabled) removeSave();
     }
 
-    void handleLevelComplete() {
+    Sequence handleLevelComplete() {
+        EventBus::emit({GameEvent::LEVEL_CLEAR, 0, 0, 0, 0, currentLevel, 0});
         currentLevel++;
         clearScreen();
-        std::cout << Color::YELLOW << "\n\n>>> 恭喜通过第 " << (currentLevel-1) << " 层！ <<<" << Color::RESET << std::endl;
-        std::cout << "稍微休息一下，准备进入下一层..." << std::endl;
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+        io.out() << Color::YELLOW << "\n\n>>> 恭喜通过第 " << (currentLevel-1) << " 层！ <<<" << Color::RESET << std::endl;
+        io.out() << "稍微休息一下，准备进入下一层..." << std::endl;
+        co_await Pause{1000};
     }
 
     // --- 7. 存档功能 (加密版) ---
-    // --- 存档功能 (自动创建文件夹版) ---
-    // --- 存档功能 (系统命令版) ---
+    // 【修改】主线程只做序列化和加密，写入存档容器（追加数据 + 新索引、fsync、改文件头）交给后台线程
     void saveGame() {
+        Memory::Scope tag(Memory::SAVE);
         // 1. 序列化与加密 (不变)
         std::stringstream ss;
         ss << currentLevel << " " << difficulty << " " 
@@ -380,58 +903,68 @@ private:
         std::string rawData = ss.str();
         std::string encryptedData = xorCipher(rawData);
         
-        // 2. 【核心修改】使用系统命令创建文件夹
-        // 这行代码会让系统去建一个叫 saves 的文件夹
-        // mkdir -p (Mac/Linux) 和 if not exist (Windows) 互不干扰
-        #ifdef _WIN32
-            system("if not exist saves mkdir saves");
-        #else
-            system("mkdir -p saves");
-        #endif
-
-        // 3. 打开文件写入 (不变)
-        std::ofstream outFile(getSaveFileName(currentSlot), std::ios::binary); 
-        
-        if (outFile.is_open()) {
-            outFile.write(encryptedData.c_str(), encryptedData.size());
-            outFile.close();
-            MessageLog::add(Color::YELLOW + ">>> 进度已保存至槽位 " + std::to_string(currentSlot) + " <<<" + Color::RESET);
-        } else {
-            MessageLog::add(Color::RED + "错误：无法写入存档 (权限被拒绝)！" + Color::RESET);
+        // 2. 交给后台写入，结果在下一帧由 reportSaveResults() 显示
+        SaveSlotInfo info;
+        info.slot = currentSlot;
+        info.level = currentLevel;
+        info.difficulty = difficulty;
+        info.mode = gameMode;
+        info.savedAt = static_cast<int64_t>(time(0));
+        saveWriter.submitTask([this, info, data = std::move(encryptedData)](std::string& error) {
+            return saveStore->write(info, data, error);
+        }, false, currentSlot);
+    }
+
+    // 【新增】删除当前槽位（同样排在后台写入队列里，保证先后顺序）
+    void removeSave() {
+        int slot = currentSlot;
+        saveWriter.submitTask([this, slot](std::string& error) { return saveStore->remove(slot, error); }, true, slot);
+    }
+
+    // 【新增】显示后台存档的完成情况
+    void reportSaveResults() {
+        for (const auto& r : saveWriter.takeResults()) {
+            if (r.isRemove && r.ok) continue;
+            if (r.ok) {
+                MessageLog::add(Color::YELLOW + ">>> 进度已保存至槽位 " + std::to_string(r.tag) + " <<<" + Color::RESET);
+            } else {
+                MessageLog::add(Color::RED + "错误：" + r.error + Color::RESET);
+            }
         }
     }
+
     // --- 8. 读档功能 (解密版) ---
     bool loadGame() {
-        // 1. 以二进制模式打开
-        std::ifstream inFile(getSaveFileName(currentSlot), std::ios::binary);
+        saveWriter.waitIdle(); // 确保读到的是最后一次写入的存档
+        // 1. 【修改】从存档容器里按索引读出这个槽位
+        std::string encryptedData, error;
         
-        if (inFile.is_open()) {
-            // 2. 读取整个文件内容到 string
-            std::stringstream buffer;
-            buffer << inFile.rdbuf();
-            std::string encryptedData = buffer.str();
-            inFile.close();
-            
+        if (saveStore->read(currentSlot, encryptedData, error)) {
             std::string decryptedData = xorCipher(encryptedData);
             std::stringstream ss(decryptedData);
             int hp, maxHp, atk;
             
             if (ss >> currentLevel >> difficulty >> hp >> maxHp >> atk >> gameMode) {
                 if (!player) player = std::make_shared<Player>(1, 1);
+                player->setActionSource(actionSource);
                 player->setStats(hp, maxHp, atk); 
                 
-                std::cout << ">>> 载入槽位 " << currentSlot << " 成功！ <<<" << std::endl;
-                std::this_thread::sleep_for(std::chrono::seconds(1));
+                io.out() << ">>> 载入槽位 " << currentSlot << " 成功！ <<<" << std::endl;
+                scheduler.run(pause(1000));
                 return true;
             } else {
                 // 如果解密后数据格式不对（说明文件被篡改或损坏）
-                std::cout << Color::RED << "存档文件损坏或被篡改！" << Color::RESET << std::endl;
-                std::this_thread::sleep_for(std::chrono::seconds(1));
+                io.out() << Color::RED << "存档文件损坏或被篡改！" << Color::RESET << std::endl;
+                scheduler.run(pause(1000));
                 return false;
             }
+        } else if (!error.empty()) {
+            io.out() << Color::RED << error << Color::RESET << std::endl;
+            scheduler.run(pause(1000));
+            return false;
         } else {
-            std::cout << Color::RED << "没有找到存档文件！" << Color::RESET << std::endl;
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+            io.out() << Color::RED << "没有找到存档文件！" << Color::RESET << std::endl;
+            scheduler.run(pause(1000));
             return false;
         }
     }
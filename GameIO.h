@@ -0,0 +1,72 @@
+#ifndef GAMEIO_H
+#define GAMEIO_H
+
+#include <iostream>
+#include <cstdlib>
+#include <mutex>
+#include "Input.h"
+
+// 一局游戏的输入输出端点
+// 每个 Game 持有自己的端点：本地终端是 ConsoleIO，服务器上的每个连接是 SessionIO
+class GameIO {
+private:
+    std::mutex outputLock;
+
+public:
+    virtual ~GameIO() = default;
+
+    // 【新增】渲染线程写一帧画面时持有这把锁；端点自己在别的线程里碰输出流（例如 flush）时也要先拿锁
+    std::mutex& outputMutex() { return outputLock; }
+
+    // 读取一个按键（没有输入时阻塞）
+    virtual char get() = 0;
+    // 是否有尚未读取的按键（非阻塞）
+    virtual bool hasPending() = 0;
+    // 丢弃所有尚未读取的按键
+    virtual void clearBuffer() = 0;
+    // 画面输出流
+    virtual std::ostream& out() = 0;
+
+    virtual void clearScreen() {
+        out() << "\033[2J\033[1;1H";
+    }
+
+    // 对端是否还在（网络连接断开后返回 false）
+    virtual bool isOpen() const { return true; }
+
+    // 是否有人在看：无人值守时跳过打字机效果、停顿和画面输出
+    virtual bool isInteractive() const { return true; }
+};
+
+// 本地终端：直接使用 Input 和 std::cout
+class ConsoleIO : public GameIO {
+public:
+    char get() override { return Input::get(); }
+    bool hasPending() override { return Input::hasPending(); }
+    void clearBuffer() override { Input::clearBuffer(); }
+    std::ostream& out() override { return std::cout; }
+
+    void clearScreen() override {
+        #ifdef _WIN32
+            system("cls");
+        #else
+            std::cout << "\033[2J\033[1;1H";
+        #endif
+    }
+};
+
+// 无人值守端点：丢弃所有输出，"按任意键"时立即返回，用于机器人批量跑图
+class NullIO : public GameIO {
+private:
+    std::ostream sink{nullptr}; // 没有缓冲区的流：所有写入直接丢弃
+
+public:
+    char get() override { return ' '; }
+    bool hasPending() override { return false; }
+    void clearBuffer() override {}
+    std::ostream& out() override { return sink; }
+    void clearScreen() override {}
+    bool isInteractive() const override { return false; }
+};
+
+#endif // GAMEIO_H
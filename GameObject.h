@@ -22,11 +22,14 @@ public:
     virtual ~GameObject() = default;
 
     // 纯虚函数：强制子类必须实现自己的绘制逻辑
-    virtual void draw() const = 0;
+    // 【修改】输出到指定的流，而不是固定的 std::cout（每局游戏有自己的输出端点）
+    virtual void draw(std::ostream& os) const = 0;
 
     // Getters
     Point getPosition() const { return pos; }
     std::string getName() const { return name; }
+    const std::string& getSymbol() const { return symbol; }
+    const std::string& getColor() const { return color; }
 
     // Setters
     void setPosition(int x, int y) {
@@ -35,8 +38,8 @@ public:
     }
     
     // 简单的通用绘制实现（子类可以复用）
-    void printSymbol() const {
-        std::cout << color << symbol << Color::RESET;
+    void printSymbol(std::ostream& os) const {
+        os << color << symbol << Color::RESET;
     }
 };
 
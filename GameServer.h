@@ -0,0 +1,264 @@
+#ifndef GAMESERVER_H
+#define GAMESERVER_H
+
+// 多人游戏服务器：在一个进程里同时托管多局独立的游戏
+// 客户端通过 Unix 域套接字连接，发送按键，服务器把渲染好的画面发回去
+// 客户端示例：socat -,icanon=0,echo=0 UNIX-CONNECT:/tmp/dungeon.sock
+#ifndef _WIN32
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <streambuf>
+#include <ostream>
+#include <cstring>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/ioctl.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "GameIO.h"
+#include "Game.h"
+
+// 把 ostream 的输出缓冲起来，flush 时整块写入套接字
+// 连接状态由渲染线程（发送失败时清除）和游戏线程（等待按键时检查）共用，所以是原子的
+class SocketStreamBuf : public std::streambuf {
+private:
+    int fd;
+    std::atomic<bool>* open;
+    char buffer[4096];
+
+    bool flushBuffer() {
+        const char* p = pbase();
+        size_t left = pptr() - pbase();
+        while (left > 0 && *open) {
+            // MSG_NOSIGNAL：对端已断开时返回错误，而不是触发 SIGPIPE 杀掉整个服务器
+            ssize_t n = send(fd, p, left, MSG_NOSIGNAL);
+            if (n <= 0) {
+                *open = false;
+                break;
+            }
+            p += n;
+            left -= n;
+        }
+        setp(buffer, buffer + sizeof(buffer));
+        return *open;
+    }
+
+protected:
+    int overflow(int c) override {
+        if (!flushBuffer()) return traits_type::eof();
+        if (c != traits_type::eof()) {
+            *pptr() = static_cast<char>(c);
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    int sync() override {
+        return flushBuffer() ? 0 : -1;
+    }
+
+public:
+    SocketStreamBuf(int socketFd, std::atomic<bool>* openFlag) : fd(socketFd), open(openFlag) {
+        setp(buffer, buffer + sizeof(buffer));
+    }
+};
+
+// 一个网络连接对应的输入输出端点
+class SessionIO : public GameIO {
+private:
+    int fd;
+    std::atomic<bool> open;
+    SocketStreamBuf buf;
+    std::ostream stream;
+
+public:
+    explicit SessionIO(int socketFd) : fd(socketFd), open(true), buf(socketFd, &open), stream(&buf) {}
+
+    char get() override {
+        {
+            // 等待输入前先把画面发出去（渲染线程可能正在写同一个流）
+            std::lock_guard<std::mutex> lock(outputMutex());
+            stream.flush();
+        }
+        char c = 0;
+        ssize_t n = open ? recv(fd, &c, 1, 0) : 0;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && open) {
+            // 超过空闲时限没有按键（见 GameServer::idleTimeout）：断开，把工作线程让给排队的人
+            const char notice[] = "\r\n长时间没有操作，连接已断开。\r\n";
+            send(fd, notice, sizeof(notice) - 1, MSG_NOSIGNAL);
+        }
+        if (n <= 0) {
+            open = false;
+            return 0;
+        }
+        return c;
+    }
+
+    bool hasPending() override {
+        int bytesWaiting = 0;
+        ioctl(fd, FIONREAD, &bytesWaiting);
+        return bytesWaiting > 0;
+    }
+
+    void clearBuffer() override {
+        char temp;
+        while (open && hasPending()) {
+            if (recv(fd, &temp, 1, 0) <= 0) open = false;
+        }
+    }
+
+    std::ostream& out() override { return stream; }
+
+    bool isOpen() const override { return open; }
+};
+
+// 服务器本体：主线程负责 accept，固定数量的工作线程负责运行游戏
+// 一个会话从连接到断开始终占用同一个工作线程（游戏循环在 recv 上阻塞等待按键），
+// 所以同时进行的对局最多等于线程数；所有工作线程都忙时，新连接排队等待，直到有人断开，
+// 而不是无限制地开线程。线程数按要同时容纳的玩家数设定，和 CPU 核数无关（等待按键的线程不占 CPU）
+// 一段时间没有任何按键的连接会被断开，挂机的客户端不会一直占着工作线程
+// 每个玩家的存档放在自己的容器 saves/player_<名字>.dat 里，不会覆盖别人同号的槽位
+class GameServer {
+private:
+    std::string socketPath;
+    int listenFd;
+    int workerCount;
+    std::vector<std::thread> workers;
+    std::deque<int> waiting; // 等待分配工作线程的连接
+    std::mutex mutex;
+    std::condition_variable hasClient;
+    int busyWorkers;
+    int idleTimeout; // 秒；0 表示不限
+    int nextSession = 1; // 连接编号，没有输入名字的访客按它区分存档
+
+    // 连接开始时询问玩家名（只接受字母、数字、下划线和减号），返回这个玩家的存档文件
+    // 直接回车则以访客身份游戏，存档按连接编号放在 saves/guest_<编号>.dat，和有名字的玩家互不冲突
+    static std::string askSaveFile(GameIO& io, int session) {
+        io.out() << "请输入玩家名（字母或数字，回车跳过）: " << std::flush;
+        std::string name;
+        while (io.isOpen()) {
+            char c = io.get();
+            bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
+            if (valid && name.size() < 16) {
+                name += c;
+                io.out() << c << std::flush;
+            } else if ((c == '\b' || c == 127) && !name.empty()) {
+                name.pop_back();
+                io.out() << "\b \b" << std::flush;
+            } else if (c == '\r' || c == '\n' || c == 0) {
+                break;
+            }
+        }
+        io.clearBuffer();
+        io.out() << std::endl;
+        return name.empty() ? "saves/guest_" + std::to_string(session) + ".dat" : "saves/player_" + name + ".dat";
+    }
+
+    void workerLoop() {
+        while (true) {
+            int client;
+            int session;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                hasClient.wait(lock, [this] { return !waiting.empty(); });
+                client = waiting.front();
+                waiting.pop_front();
+                busyWorkers++;
+                session = nextSession++;
+            }
+
+            // 整局游戏都在这个线程里运行，期间它不会去服务其他连接
+            if (idleTimeout > 0) {
+                timeval limit{};
+                limit.tv_sec = idleTimeout;
+                setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &limit, sizeof(limit));
+            }
+            {
+                SessionIO io(client);
+                std::string saveFile = askSaveFile(io, session);
+                Game game(io);
+                game.setSaveFile(saveFile);
+                game.run();
+                io.out().flush();
+            }
+            close(client);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers--;
+        }
+    }
+
+public:
+    static const int DEFAULT_SESSIONS = 32;        // 默认最多同时进行的对局数
+    static const int DEFAULT_IDLE_TIMEOUT = 600;   // 默认空闲 10 分钟断开
+
+    GameServer(const std::string& path, int sessions = DEFAULT_SESSIONS, int idleSeconds = DEFAULT_IDLE_TIMEOUT)
+        : socketPath(path), listenFd(-1), workerCount(sessions > 0 ? sessions : 1), busyWorkers(0),
+          idleTimeout(idleSeconds > 0 ? idleSeconds : 0) {}
+
+    // 启动服务器并一直运行；启动失败返回非 0
+    int run() {
+        listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd < 0) {
+            std::cerr << "无法创建套接字: " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (socketPath.size() >= sizeof(addr.sun_path)) {
+            std::cerr << "套接字路径太长: " << socketPath << std::endl;
+            return 1;
+        }
+        std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(socketPath.c_str()); // 清理上次运行残留的套接字文件
+
+        if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+            listen(listenFd, 64) < 0) {
+            std::cerr << "无法监听 " << socketPath << ": " << std::strerror(errno) << std::endl;
+            close(listenFd);
+            return 1;
+        }
+
+        for (int i = 0; i < workerCount; ++i) {
+            workers.emplace_back(&GameServer::workerLoop, this);
+        }
+        std::cout << "服务器已启动: " << socketPath << " (最多同时 " << workerCount << " 局";
+        if (idleTimeout > 0) std::cout << "，空闲 " << idleTimeout << " 秒断开";
+        std::cout << ")" << std::endl;
+
+        while (true) {
+            int client = accept(listenFd, nullptr, nullptr);
+            if (client < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "accept 失败: " << std::strerror(errno) << std::endl;
+                break;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (busyWorkers + static_cast<int>(waiting.size()) >= workerCount) {
+                const char notice[] = "服务器已满，正在排队，请稍候...\r\n";
+                send(client, notice, sizeof(notice) - 1, MSG_NOSIGNAL);
+            }
+            waiting.push_back(client);
+            hasClient.notify_one();
+        }
+
+        close(listenFd);
+        unlink(socketPath.c_str());
+        for (auto& t : workers) t.detach(); // 工作线程里的对局随进程一起结束
+        return 1;
+    }
+};
+
+#endif // _WIN32
+
+#endif // GAMESERVER_H
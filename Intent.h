@@ -0,0 +1,70 @@
+#ifndef INTENT_H
+#define INTENT_H
+
+#include <vector>
+#include "Creature.h"
+#include "Map.h"
+#include "Random.h"
+
+// 怪物在"决策阶段"给出的意图，由"结算阶段"统一执行
+struct Intent {
+    enum Type { WAIT, MOVE, ATTACK };
+
+    Type type = WAIT;
+    Point target{0, 0};   // MOVE: 目标格子；ATTACK: 被攻击者所在格子
+    int targetIndex = -1; // ATTACK: 被攻击者在快照中的下标
+};
+
+// 回合开始时的只读世界快照
+// 决策阶段可能在多个线程上同时读取，因此这里只存值，不存会被修改的状态
+struct TurnSnapshot {
+    const Map* map = nullptr;
+    int width = 0;
+    int height = 0;
+    int heroIndex = -1;
+    std::vector<Creature*> creatures; // 与 positions 一一对应，仅用于结算阶段
+    std::vector<Point> positions;
+    std::vector<unsigned> seeds;      // 每个生物本回合的随机数种子（按顺序生成，结果可复现）
+    std::vector<int> occupant;        // 格子 -> 生物下标，-1 表示空地
+
+    // 重新拍摄快照；occupant 只清理上回合写过的格子，大地图上也是 O(生物数)
+    void build(const Map& m, const std::vector<Creature*>& list, Rng& rng) {
+        if (m.getWidth() != width || m.getHeight() != height || occupant.empty()) {
+            width = m.getWidth();
+            height = m.getHeight();
+            occupant.assign(static_cast<size_t>(width) * height, -1);
+        } else {
+            for (const auto& p : positions) occupant[p.y * width + p.x] = -1;
+        }
+        map = &m;
+        heroIndex = -1;
+        creatures.clear();
+        positions.clear();
+        seeds.clear();
+
+        for (auto* c : list) {
+            if (c->isDead()) continue; // 尸体不占格子，也不行动
+            int index = static_cast<int>(creatures.size());
+            Point p = c->getPosition();
+            creatures.push_back(c);
+            positions.push_back(p);
+            seeds.push_back(static_cast<unsigned>(rng.next()));
+            occupant[p.y * width + p.x] = index;
+            if (c->getName() == "Hero") heroIndex = index;
+        }
+    }
+
+    int occupantAt(int x, int y) const {
+        if (x < 0 || x >= width || y < 0 || y >= height) return -1;
+        return occupant[y * width + x];
+    }
+
+    int indexOf(const Creature* c) const {
+        for (size_t i = 0; i < creatures.size(); ++i) {
+            if (creatures[i] == c) return static_cast<int>(i);
+        }
+        return -1;
+    }
+};
+
+#endif // INTENT_H
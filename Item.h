@@ -3,7 +3,7 @@
 
 #include "GameObject.h"
 #include "Player.h"
-#include "MessageLog.h"
+#include "EventBus.h"
 
 class Item : public GameObject {
 public:
@@ -12,12 +12,22 @@ public:
 
     // 【关键修复】实现父类的纯虚函数 draw
     // 所有的物品（剑、药水）都通用这个绘制逻辑
-    void draw() const override {
-        printSymbol();
+    void draw(std::ostream& os) const override {
+        printSymbol(os);
     }
 
     // 纯虚函数：物品被玩家触碰时发生什么
     virtual bool onPickUp(Player* p) = 0;
+
+    // 【新增】快照恢复时按种类重新创建物品
+    virtual ItemKind kind() const = 0;
+
+protected:
+    // 【新增】拾取结果以事件形式投递（日志由 MessageLogSink 生成）
+    void emitPickup(GameEvent::Type type, int amount) const {
+        EventBus::emit({type, static_cast<uint8_t>(kind()), static_cast<uint8_t>(CreatureKind::HERO),
+                        static_cast<int16_t>(pos.x), static_cast<int16_t>(pos.y), amount, 0});
+    }
 };
 
 // 治疗药水
@@ -25,14 +35,16 @@ class Potion : public Item {
     int healAmount;
 public:
     Potion(int x, int y) : Item(x, y, "!", "Potion", Color::MAGENTA), healAmount(30) {}
+
+    ItemKind kind() const override { return ItemKind::POTION; }
     
     bool onPickUp(Player* p) override {
         if (p->getHp() < p->getMaxHp()) {
             p->heal(healAmount); 
-            MessageLog::add("你喝下了药水，恢复了 " + std::to_string(healAmount) + " 点 HP!");
+            emitPickup(GameEvent::ITEM_USED, healAmount);
             return true;
         } else {
-            MessageLog::add("你生命值是满的，现在不需要药水。");
+            emitPickup(GameEvent::ITEM_DECLINED, 0);
             return false;
         }
     }
@@ -44,9 +56,11 @@ class Sword : public Item {
 public:
     Sword(int x, int y) : Item(x, y, "/", "Excalibur", Color::YELLOW), atkBonus(5) {}
 
+    ItemKind kind() const override { return ItemKind::SWORD; }
+
     bool onPickUp(Player* p) override {
         p->buffAttack(atkBonus); 
-        MessageLog::add("你拔出了石中剑！攻击力增加了 " + std::to_string(atkBonus) + " 点!");
+        emitPickup(GameEvent::ITEM_USED, atkBonus);
         return true;
     }
 };
@@ -0,0 +1,102 @@
+#ifndef LEVELCACHE_H
+#define LEVELCACHE_H
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include "Map.h"
+#include "WorldSnapshot.h"
+
+// 已经去过的楼层：地形按行程编码（RLE）压缩，怪物和物品只存快照记录（见 WorldSnapshot.h）
+// 回到这一层时解压即可，不用重新生成；怪物的血量、位置和剩下的物品都和离开时一样
+struct CachedLevel {
+    int level = 0;
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> tiles;            // (连续个数, 字符) 成对存放，连续个数最大 255
+    std::vector<CreatureRecord> creatures; // 不含玩家
+    std::vector<ItemRecord> items;
+
+    void compressTiles(const Map& map) {
+        width = map.getWidth();
+        height = map.getHeight();
+        std::vector<char> raw(static_cast<size_t>(width) * height);
+        map.storeTiles(raw.data());
+
+        tiles.clear();
+        size_t i = 0;
+        while (i < raw.size()) {
+            char tile = raw[i];
+            size_t run = 1;
+            while (i + run < raw.size() && raw[i + run] == tile && run < 255) run++;
+            tiles.push_back(static_cast<uint8_t>(run));
+            tiles.push_back(static_cast<uint8_t>(tile));
+            i += run;
+        }
+    }
+
+    void decompressTiles(Map& map) const {
+        std::vector<char> raw;
+        raw.reserve(static_cast<size_t>(width) * height);
+        for (size_t i = 0; i + 1 < tiles.size(); i += 2) raw.insert(raw.end(), tiles[i], static_cast<char>(tiles[i + 1]));
+        map.loadTiles(raw.data(), width, height);
+    }
+
+    size_t bytes() const {
+        return sizeof(CachedLevel) + tiles.capacity() + creatures.capacity() * sizeof(CreatureRecord)
+               + items.capacity() * sizeof(ItemRecord);
+    }
+};
+
+// 按最近使用淘汰的楼层缓存：无尽模式打得再深，也只保留最近 capacity 层
+// 被淘汰的楼层回去时重新生成
+class LevelCache {
+private:
+    size_t capacity;
+    std::list<CachedLevel> entries; // 最近使用的在前面
+    std::unordered_map<int, std::list<CachedLevel>::iterator> index;
+
+public:
+    explicit LevelCache(size_t maxLevels) : capacity(maxLevels > 0 ? maxLevels : 1) {}
+
+    // 存入（同一层的旧记录被替换），超出容量时淘汰最久没用过的
+    void put(CachedLevel&& level) {
+        auto found = index.find(level.level);
+        if (found != index.end()) {
+            entries.erase(found->second);
+            index.erase(found);
+        }
+        entries.push_front(std::move(level));
+        index[entries.front().level] = entries.begin();
+        while (entries.size() > capacity) {
+            index.erase(entries.back().level);
+            entries.pop_back();
+        }
+    }
+
+    // 取出某一层（从缓存中移除，离开时再 put 回来）；没有缓存时返回 false
+    bool take(int level, CachedLevel& out) {
+        auto found = index.find(level);
+        if (found == index.end()) return false;
+        out = std::move(*found->second);
+        entries.erase(found->second);
+        index.erase(found);
+        return true;
+    }
+
+    void clear() {
+        entries.clear();
+        index.clear();
+    }
+
+    size_t size() const { return entries.size(); }
+
+    size_t bytes() const {
+        size_t total = 0;
+        for (const auto& e : entries) total += e.bytes();
+        return total;
+    }
+};
+
+#endif // LEVELCACHE_H
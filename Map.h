@@ -5,8 +5,13 @@
 #include <string>
 #include <iostream>
 #include <memory>
-#include <queue> // 【新增】用于 BFS 寻路算法
 #include "GameObject.h"
+#include "PathFinder.h"
+#include "Frame.h"
+#include "Random.h"
+#include "CaveGenerator.h"
+#include "ObstacleGenerator.h"
+#include "BitGrid.h"
 #include "utils.h"
 
 class Map {
@@ -14,13 +19,68 @@ private:
     int width;
     int height;
     std::vector<std::string> grid; 
+    // 【新增】寻路服务：缓冲区随地图一起分配，查询时复用
+    // 【修改】每次寻路都会改写这些缓冲区，所以 getDistance / findPath 不是 const，
+    // 同一张地图上的寻路不能在多个线程里同时进行（怪物并行决策时拿到的是 const Map*，用不了）
+    PathFinder pathFinder;
+    // 【新增】连通分量标号：每个可走格子属于哪一片互相走得到的区域（墙为 -1）
+    // 地形每次改变后由 relabel() 重新计算；之后"能不能走到"只需比较两个标号
+    // 只在修改地形的函数里写入，isConnected / componentAt 是只读的，怪物并行决策时可以放心使用
+    std::vector<int> labels;
+    std::vector<int> labelParent; // 并查集（复用缓冲区）
+    // 【新增】生成阶段校验连通性用的位图（可走格子 / 已到达格子）：每次尝试只需判断通不通，
+    // 用按位的洪水填充就够了，标号只在最终采用的地图上计算一次
+    BitGrid walkableBits;
+    BitGrid reachedBits;
 
-public:
-    Map(int w, int h) : width(w), height(h) {
-        generateDefaultMap();
+    int findRoot(int i) {
+        while (labelParent[i] != i) {
+            labelParent[i] = labelParent[labelParent[i]]; // 路径减半
+            i = labelParent[i];
+        }
+        return i;
     }
 
-    void generateDefaultMap() {
+    // 两遍扫描的并查集标号（按上下左右连通，与玩家的移动方式一致）：
+    // 第一遍按行扫描，每个格子继承上方或左方的临时标号，两者不同时合并；第二遍把临时标号换成连续的分量编号
+    void relabel() {
+        labels.assign(static_cast<size_t>(width) * height, -1);
+        labelParent.clear();
+        for (int y = 0; y < height; ++y) {
+            const std::string& row = grid[y];
+            for (int x = 0; x < width; ++x) {
+                if (row[x] == '#') continue;
+                int i = y * width + x;
+                int up = (y > 0) ? labels[i - width] : -1;
+                int left = (x > 0) ? labels[i - 1] : -1;
+                if (up < 0 && left < 0) {
+                    labels[i] = static_cast<int>(labelParent.size());
+                    labelParent.push_back(labels[i]);
+                } else if (up < 0 || left < 0) {
+                    labels[i] = up < 0 ? left : up;
+                } else {
+                    int a = findRoot(up), b = findRoot(left);
+                    if (a != b) labelParent[a > b ? a : b] = a < b ? a : b;
+                    labels[i] = a < b ? a : b;
+                }
+            }
+        }
+
+        // 根 -> 连续编号（借用 labelParent 之后的空间存放映射）
+        size_t tentative = labelParent.size();
+        labelParent.resize(tentative * 2, -1);
+        int components = 0;
+        for (int& label : labels) {
+            if (label < 0) continue;
+            int root = findRoot(label);
+            int& id = labelParent[tentative + root];
+            if (id < 0) id = components++;
+            label = id;
+        }
+    }
+
+    // 只有边框的空房间（不重新标号，生成时每次重试都从这里开始）
+    void fillEmptyRoom() {
         grid.clear();
         for (int y = 0; y < height; ++y) {
             std::string row = "";
@@ -36,133 +96,159 @@ public:
         grid[height-2][width-2] = '>';
     }
 
+    // 生成阶段的校验：把可走格子打包成位图，从 start 做按位洪水填充，看能否到达 end
+    bool isReachable(Point start, Point end) {
+        walkableBits.resize(width, height);
+        for (int y = 0; y < height; ++y) {
+            const std::string& row = grid[y];
+            uint64_t* bits = walkableBits.row(y);
+            for (int x = 0; x < width; ++x) {
+                if (row[x] != '#') bits[x >> 6] |= 1ULL << (x & 63);
+            }
+        }
+        return BitFill::floodFill(walkableBits, start.x, start.y, reachedBits, end.x, end.y);
+    }
+
+public:
+    Map(int w, int h) : width(w), height(h) {
+        pathFinder.resize(w, h);
+        generateDefaultMap();
+    }
+
+    void generateDefaultMap() {
+        fillEmptyRoom();
+        relabel();
+    }
+
+    // 【新增】用一块按行排列的格子数据覆盖地图（尺寸必须一致），供 FixedMap 生成后写回
+    void loadTiles(const char* tiles, int w, int h) {
+        if (w != width || h != height) return;
+        grid.resize(height);
+        for (int y = 0; y < height; ++y) grid[y].assign(tiles + y * width, width);
+        relabel();
+    }
+
+    // 【新增】把格子按行写入 out（至少 width * height 字节），供世界快照使用
+    void storeTiles(char* out) const {
+        for (int y = 0; y < height; ++y) grid[y].copy(out + y * width, width);
+    }
+
     bool isWalkable(int x, int y) const {
         if (x < 0 || x >= width || y < 0 || y >= height) return false;
         char tile = grid[y][x];
         return tile != '#'; 
     }
 
-    // --- 【新增】BFS 路径检查算法 ---
-    // 检查从 (startX, startY) 是否能走到 (endX, endY)
-    bool hasPath(int startX, int startY, int endX, int endY) {
-        // 1. 如果起点或终点本身就是墙，直接死局
-        if (!isWalkable(startX, startY) || !isWalkable(endX, endY)) return false;
-
-        // 2. 准备访问记录表 (visited)，防止兜圈子
-        std::vector<std::vector<bool>> visited(height, std::vector<bool>(width, false));
-        
-        // 3. BFS 队列
-        std::queue<Point> q;
-        q.push({startX, startY});
-        visited[startY][startX] = true;
-
-        // 4. 方向数组：上下左右
-        int dirs[4][2] = {{0, 1}, {0, -1}, {1, 0}, {-1, 0}};
-
-        while (!q.empty()) {
-            Point curr = q.front();
-            q.pop();
-
-            // 如果到达终点，说明通路存在！
-            if (curr.x == endX && curr.y == endY) return true;
-
-            // 探索四周
-            for (auto& dir : dirs) {
-                int nx = curr.x + dir[0];
-                int ny = curr.y + dir[1];
-
-                // 检查边界、是否是墙、是否访问过
-                if (nx >= 0 && nx < width && ny >= 0 && ny < height && 
-                    isWalkable(nx, ny) && !visited[ny][nx]) {
-                    
-                    visited[ny][nx] = true;
-                    q.push({nx, ny});
-                }
-            }
+    // 【修改】只判断能否走到：比较两个格子的连通分量标号，O(1)，不再每次做洪水填充
+    bool isConnected(Point a, Point b) const {
+        int label = componentAt(a.x, a.y);
+        return label >= 0 && label == componentAt(b.x, b.y);
+    }
+
+    // 【新增】格子所在的连通分量编号，墙和地图外为 -1
+    int componentAt(int x, int y) const {
+        if (x < 0 || x >= width || y < 0 || y >= height) return -1;
+        return labels[y * width + x];
+    }
+
+    // 【新增】最短步数，不可达返回 -1
+    int getDistance(Point start, Point end) {
+        return pathFinder.distance(start, end, [this](int x, int y) { return isWalkable(x, y); });
+    }
+
+    // 【新增】完整路径（不含起点，含终点），返回步数，不可达返回 -1
+    // avoidUpStairs：路上不经过上楼的楼梯（起点、终点除外），机器人不会误走回上一层
+    int findPath(Point start, Point end, std::vector<Point>& outPath, bool avoidUpStairs = false) {
+        if (!avoidUpStairs) {
+            return pathFinder.findPath(start, end, [this](int x, int y) { return isWalkable(x, y); }, outPath);
         }
+        return pathFinder.findPath(start, end, [this, start, end](int x, int y) {
+            if (!isWalkable(x, y)) return false;
+            return !isUpStairs(x, y) || (x == start.x && y == start.y) || (x == end.x && y == end.y);
+        }, outPath);
+    }
 
-        // 5. 队列空了也没找到终点，说明路断了
-        return false;
+    // 【新增】上楼的楼梯 '<'：玩家走上去就回到上一层
+    void placeUpStairs(Point p) {
+        bool wasWall = grid[p.y][p.x] == '#';
+        grid[p.y][p.x] = '<';
+        if (wasWall) relabel();
+    }
+    bool isUpStairs(int x, int y) const {
+        return x >= 0 && x < width && y >= 0 && y < height && grid[y][x] == '<';
     }
 
     // --- 【修改】生成障碍物 ---
-    // 使用 while 循环，直到生成出一张能通关的地图为止
-    void generateObstacles(int level) {
-        bool pathFound = false;
-        int attempts = 0;
-
-        do {
-            // 1. 重置为空房间
-            generateDefaultMap();
-
-            // 2. 随机撒墙
-            // 随着等级提升，墙壁密度增加，但设置上限防止死循环
-            int obstacleCount = (width * height) / 10 + (level * 5);
-            // 简单的防止密度过大
-            if (obstacleCount > (width * height) * 0.6) obstacleCount = (width * height) * 0.6;
-
-            for (int i = 0; i < obstacleCount; ++i) {
-                int x = rand() % (width - 2) + 1;
-                int y = rand() % (height - 2) + 1;
-
-                // 保护起点和终点不被直接覆盖
-                // 同时保护起点周围一圈，防止出门就被堵死
-                if ((std::abs(x - 1) <= 1 && std::abs(y - 1) <= 1) || 
-                    (x == width - 2 && y == height - 2)) {
-                    continue;
-                }
-                
-                grid[y][x] = '#';
-            }
-
-            // 3. 检查死活：从 (1,1) 到 (width-2, height-2) 有路吗？
-            pathFound = hasPath(1, 1, width - 2, height - 2);
-            
-            attempts++;
-            // 防止极其罕见的无限循环（虽然 BFS 保证了只要有解就能找到）
-            if (attempts > 1000) {
-                // 如果实在随机不出来，就生成一个空地图保底
-                generateDefaultMap();
-                pathFound = true; 
-            }
+    // 直到生成出一张能通关的地图为止（算法见 ObstacleGenerator.h，与 FixedMap 共用）
+    // 【修改】随机数来自调用者传入的 rng，同一个种子生成同一张地图
+    // 每次尝试只用按位洪水填充判断通不通；标号等地图定下来以后再算
+    void generateObstacles(int level, Rng& rng) {
+        Obstacles::generate(width, height, level, rng,
+            [this] { fillEmptyRoom(); },
+            [this](int x, int y) { grid[y][x] = '#'; },
+            [this] { return isReachable({1, 1}, {width - 2, height - 2}); });
+        relabel(); // 只给最终采用的地图标号，供之后的刷怪和 AI 使用
+    }
 
-        } while (!pathFound); // 如果没路，就回滚重来
-        
-        // 可选：在这里打印一下 "Generated map in X attempts" 方便调试
-        // std::cout << "Map generated in " << attempts << " attempts." << std::endl;
+    // 【新增】洞穴风格的地图（元胞自动机，见 CaveGenerator.h），同样保证起点能走到出口
+    void generateCave(int level, Rng& rng) {
+        BitGrid walls;
+        Cave::generate(walls, width, height, level, rng);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) grid[y][x] = walls.test(x, y) ? '#' : '.';
+        }
+        grid[height-2][width-2] = '>';
+        relabel();
     }
 
-    void draw(const std::vector<GameObject*>& objects) const {
-        #ifdef _WIN32
-            system("cls");
-        #else
-            std::cout << "\033[2J\033[1;1H"; 
-        #endif
+    // 【新增】压力测试用：每个内部格子以 density 的概率变成墙（起点一圈和出口除外）
+    // 起点走不到出口时，沿第 1 行和倒数第 2 列挖一条 L 形通道，保证场景总能开始
+    void generateScattered(float density, Rng& rng) {
+        fillEmptyRoom();
+        int permille = static_cast<int>(density * 1000);
+        for (int y = 1; y < height - 1; ++y) {
+            for (int x = 1; x < width - 1; ++x) {
+                if (x <= 2 && y <= 2) continue;
+                if (rng.nextInt(1000) < permille) grid[y][x] = '#';
+            }
+        }
+        grid[height-2][width-2] = '>';
+        if (!isReachable({1, 1}, {width - 2, height - 2})) {
+            for (int x = 1; x < width - 1; ++x) grid[1][x] = '.';
+            for (int y = 1; y < height - 2; ++y) grid[y][width - 2] = '.';
+        }
+        relabel();
+    }
 
+    // 【新增】把地图和物体写入一帧画面
+    // 先铺地形，再倒序盖上物体：列表靠前的物体最后写入，和原来"先匹配先画"的效果一致
+    // 复杂度 O(格子数 + 物体数)，不再对每个格子遍历所有物体
+    void buildFrame(const std::vector<GameObject*>& objects, Frame& frame) const {
+        frame.resize(width, height);
+        static const unsigned char wallColor = Palette::indexOf(Color::GREY);
+        static const unsigned char exitColor = Palette::indexOf(Color::YELLOW);
         for (int y = 0; y < height; ++y) {
             for (int x = 0; x < width; ++x) {
-                bool objectDrawn = false;
-                for (const auto* obj : objects) {
-                    if (obj->getPosition().x == x && obj->getPosition().y == y) {
-                        obj->draw();
-                        objectDrawn = true;
-                        break;
-                    }
-                }
-
-                if (!objectDrawn) {
-                    char tile = grid[y][x];
-                    if (tile == '#') {
-                        std::cout << Color::GREY << tile << Color::RESET;
-                    } else if (tile == '>') {
-                        std::cout << Color::YELLOW << tile << Color::RESET;
-                    } else {
-                        std::cout << tile;
-                    }
-                }
+                char tile = grid[y][x];
+                unsigned char color = 0;
+                if (tile == '#') color = wallColor;
+                else if (tile == '>' || tile == '<') color = exitColor;
+                frame.at(x, y) = {tile, color};
             }
-            std::cout << std::endl;
         }
+        for (auto it = objects.rbegin(); it != objects.rend(); ++it) {
+            Point p = (*it)->getPosition();
+            if (p.x < 0 || p.x >= width || p.y < 0 || p.y >= height) continue;
+            const std::string& sym = (*it)->getSymbol();
+            frame.at(p.x, p.y) = {sym.empty() ? '?' : sym[0], Palette::indexOf((*it)->getColor())};
+        }
+    }
+
+    // 【修改】清屏交给调用者（GameIO::clearScreen），这里只负责把地图画到 os
+    void draw(std::ostream& os, const std::vector<GameObject*>& objects) const {
+        Frame frame;
+        buildFrame(objects, frame);
+        frame.render(os);
     }
 
     int getWidth() const { return width; }
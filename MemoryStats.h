@@ -0,0 +1,117 @@
+#ifndef MEMORYSTATS_H
+#define MEMORYSTATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// 按子系统统计内存：
+// main.cpp 里替换了全局 operator new / delete，每块内存前面多留 16 字节记录大小和所属子系统。
+// 当前子系统由线程局部的"标签"决定，用 Memory::Scope 在代码块里临时切换：
+//     { Memory::Scope tag(Memory::MAP_GRID); map = std::make_unique<Map>(w, h); }
+// 释放时按块头里记录的标签扣减，所以在哪里释放都不会记错账。
+// 编译时定义 NO_MEMORY_TRACKING 可以关掉替换（统计全为 0）
+// 计数器是整个进程共用的，不区分是哪一局游戏：--server、--balance 同时跑多局时统计混在一起，没有意义
+namespace Memory {
+    enum Tag { OTHER, MAP_GRID, CREATURES, ITEMS, MESSAGE_LOG, RENDER, SAVE, TAG_COUNT };
+
+    inline const char* tagName(int tag) {
+        static const char* names[TAG_COUNT] = {
+            "其他", "地图", "生物", "物品", "日志", "渲染", "存档"
+        };
+        return (tag >= 0 && tag < TAG_COUNT) ? names[tag] : "?";
+    }
+
+    struct Counters {
+        std::atomic<long long> live{0};    // 当前占用字节
+        std::atomic<long long> peak{0};    // 峰值字节（可以按关卡重置）
+        std::atomic<long long> allocs{0};  // 累计分配次数
+    };
+
+    inline Counters* counters() {
+        static Counters all[TAG_COUNT];
+        return all;
+    }
+
+    inline int& currentTag() {
+        static thread_local int tag = OTHER;
+        return tag;
+    }
+
+    // 在作用域内把当前线程的分配记到 tag 名下
+    class Scope {
+    private:
+        int previous;
+
+    public:
+        explicit Scope(Tag tag) : previous(currentTag()) { currentTag() = tag; }
+        ~Scope() { currentTag() = previous; }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    // 某一时刻的统计值（普通结构体，可以随意复制保存）
+    struct Snapshot {
+        long long live[TAG_COUNT];
+        long long peak[TAG_COUNT];
+        long long allocs[TAG_COUNT];
+    };
+
+    inline Snapshot snapshot() {
+        Snapshot s;
+        for (int i = 0; i < TAG_COUNT; ++i) {
+            s.live[i] = counters()[i].live.load(std::memory_order_relaxed);
+            s.peak[i] = counters()[i].peak.load(std::memory_order_relaxed);
+            s.allocs[i] = counters()[i].allocs.load(std::memory_order_relaxed);
+        }
+        return s;
+    }
+
+    // 把峰值重置为当前占用（例如每层开始时），之后的 peak 就是这一段时间里的峰值
+    inline void resetPeaks() {
+        for (int i = 0; i < TAG_COUNT; ++i) {
+            counters()[i].peak.store(counters()[i].live.load(std::memory_order_relaxed),
+                                     std::memory_order_relaxed);
+        }
+    }
+
+    // --- 供全局 operator new / delete 使用 ---
+
+    struct alignas(16) BlockHeader {
+        std::size_t size;
+        int tag;
+    };
+
+    inline void* trackedAlloc(std::size_t size) {
+        void* raw = std::malloc(sizeof(BlockHeader) + (size ? size : 1));
+        if (!raw) return nullptr;
+        BlockHeader* header = static_cast<BlockHeader*>(raw);
+        header->size = size;
+        header->tag = currentTag();
+
+        Counters& c = counters()[header->tag];
+        long long now = c.live.fetch_add(static_cast<long long>(size), std::memory_order_relaxed) + size;
+        c.allocs.fetch_add(1, std::memory_order_relaxed);
+        long long peak = c.peak.load(std::memory_order_relaxed);
+        while (now > peak && !c.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+        return header + 1;
+    }
+
+    // 不允许内联进 operator delete：否则编译器在调用处看到"对 new 出来的指针往回退一个头再 free"，
+    // 会误报 -Warray-bounds 和 -Wmismatched-new-delete
+    #ifdef _MSC_VER
+        #define MEMORY_NOINLINE __declspec(noinline)
+    #else
+        #define MEMORY_NOINLINE __attribute__((noinline))
+    #endif
+
+    MEMORY_NOINLINE inline void trackedFree(void* p) {
+        if (!p) return;
+        BlockHeader* header = reinterpret_cast<BlockHeader*>(static_cast<char*>(p) - sizeof(BlockHeader));
+        counters()[header->tag].live.fetch_sub(static_cast<long long>(header->size), std::memory_order_relaxed);
+        std::free(header);
+    }
+}
+
+#endif // MEMORYSTATS_H
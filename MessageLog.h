@@ -3,14 +3,17 @@
 
 #include <vector>
 #include <string>
+#include "MemoryStats.h"
 
 // 简单的静态日志系统，也可以设计成单例，这里为了简单直接做成静态工具类
+// 【修改】日志按线程隔离：服务器上每局游戏跑在自己的线程里，互不串台
 class MessageLog {
 public:
-    static std::vector<std::string> logs;
+    static thread_local std::vector<std::string> logs;
     
     // 添加一条日志
     static void add(const std::string& msg) {
+        Memory::Scope tag(Memory::MESSAGE_LOG);
         logs.push_back(msg);
         // 保持只显示最近的 5 条，防止屏幕溢出
         if (logs.size() > 5) {
@@ -32,5 +35,5 @@ public:
 // 在 .cpp 文件中定义静态成员，但在头文件模式下，
 // 我们可以用 C++17 的 inline 变量，或者简单点在 main.cpp 里定义一次
 // 这里为了防报错，我们暂时不做外部定义，而是每次包含时注意链接问题。
-// *规范做法*：应该在 main.cpp 开头写 std::vector<std::string> MessageLog::logs;
+// *规范做法*：应该在 main.cpp 开头写 thread_local std::vector<std::string> MessageLog::logs;
 #endif
\ No newline at end of file
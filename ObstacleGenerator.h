@@ -0,0 +1,57 @@
+#ifndef OBSTACLEGENERATOR_H
+#define OBSTACLEGENERATOR_H
+
+#include <cstdlib>
+#include "Random.h"
+
+// 随机撒墙的关卡生成（剧情模式和无尽模式的普通层）
+// 算法和随机数的调用顺序只写在这里一处：Map 和编译期尺寸的 FixedMap 都调用它，
+// 各自只提供格子怎么存放——同一个种子无论走哪条路径都生成同一张地图
+//   resetRoom()          恢复成只有边框的空房间（出口在右下角）
+//   placeWall(x, y)      把内部格子 (x, y) 变成墙
+//   exitReachable()      起点 (1,1) 能否走到出口 (w-2,h-2)
+namespace Obstacles {
+
+    template <typename ResetRoom, typename PlaceWall, typename ExitReachable>
+    void generate(int width, int height, int level, Rng& rng,
+                  ResetRoom&& resetRoom, PlaceWall&& placeWall, ExitReachable&& exitReachable) {
+        bool pathFound = false;
+        int attempts = 0;
+
+        // 使用 while 循环，直到生成出一张能通关的地图为止
+        do {
+            // 1. 重置为空房间
+            resetRoom();
+
+            // 2. 随机撒墙
+            // 随着等级提升，墙壁密度增加，但设置上限防止死循环
+            int obstacleCount = (width * height) / 10 + (level * 5);
+            if (obstacleCount > (width * height) * 0.6) obstacleCount = (width * height) * 0.6;
+
+            for (int i = 0; i < obstacleCount; ++i) {
+                int x = rng.nextInt(width - 2) + 1;
+                int y = rng.nextInt(height - 2) + 1;
+
+                // 保护起点和终点不被直接覆盖
+                // 同时保护起点周围一圈，防止出门就被堵死
+                if ((std::abs(x - 1) <= 1 && std::abs(y - 1) <= 1) ||
+                    (x == width - 2 && y == height - 2)) {
+                    continue;
+                }
+                placeWall(x, y);
+            }
+
+            // 3. 检查死活：从起点到出口有路吗？
+            pathFound = exitReachable();
+
+            attempts++;
+            // 防止极其罕见的无限循环：实在随机不出来，就用空地图保底
+            if (attempts > 1000) {
+                resetRoom();
+                pathFound = true;
+            }
+        } while (!pathFound); // 如果没路，就回滚重来
+    }
+}
+
+#endif // OBSTACLEGENERATOR_H
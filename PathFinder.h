@@ -0,0 +1,185 @@
+#ifndef PATHFINDER_H
+#define PATHFINDER_H
+
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include "utils.h"
+
+// A* 寻路服务：由 Map 持有，可以被地图生成检查和怪物 AI 反复调用
+// 所有临时缓冲区都在多次查询之间复用：
+//   - 访问记录使用"代数戳"：每次查询只把 generation 加一，不需要清空数组
+//   - 开放列表是一个带位置索引的二叉堆，支持 decrease-key，每个格子最多入堆一次
+// 只要地图尺寸不变，查询过程中不会发生任何堆内存分配
+class PathFinder {
+private:
+    int width = 0;
+    int height = 0;
+    unsigned generation = 0;
+
+    std::vector<unsigned> seenStamp;   // 该格本次查询是否已有 gScore
+    std::vector<unsigned> closedStamp; // 该格本次查询是否已经出堆
+    std::vector<int> gScore;
+    std::vector<int> fScore;
+    std::vector<int> parent;
+    std::vector<int> heap;     // 存放格子下标的最小堆（按 fScore 排序）
+    std::vector<int> heapPos;  // 格子在 heap 中的位置，用于 decrease-key
+
+    // 新一轮查询：代数加一，溢出时才真正清空一次
+    void nextGeneration() {
+        if (++generation == 0) {
+            std::fill(seenStamp.begin(), seenStamp.end(), 0u);
+            std::fill(closedStamp.begin(), closedStamp.end(), 0u);
+            generation = 1;
+        }
+        heap.clear(); // clear 不释放容量
+    }
+
+    // 堆序：f 小者优先；f 相同时 g 大者优先（更靠近终点，减少展开）
+    bool less(int a, int b) const {
+        if (fScore[a] != fScore[b]) return fScore[a] < fScore[b];
+        return gScore[a] > gScore[b];
+    }
+
+    void siftUp(int i) {
+        int cell = heap[i];
+        while (i > 0) {
+            int p = (i - 1) / 2;
+            if (!less(cell, heap[p])) break;
+            heap[i] = heap[p];
+            heapPos[heap[i]] = i;
+            i = p;
+        }
+        heap[i] = cell;
+        heapPos[cell] = i;
+    }
+
+    void siftDown(int i) {
+        int n = static_cast<int>(heap.size());
+        int cell = heap[i];
+        while (true) {
+            int l = i * 2 + 1;
+            if (l >= n) break;
+            int r = l + 1;
+            int best = (r < n && less(heap[r], heap[l])) ? r : l;
+            if (!less(heap[best], cell)) break;
+            heap[i] = heap[best];
+            heapPos[heap[i]] = i;
+            i = best;
+        }
+        heap[i] = cell;
+        heapPos[cell] = i;
+    }
+
+    int popMin() {
+        int top = heap[0];
+        int last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            siftDown(0);
+        }
+        return top;
+    }
+
+    int heuristic(int cell, int goalX, int goalY) const {
+        return std::abs(cell % width - goalX) + std::abs(cell / width - goalY);
+    }
+
+    // A* 主体：返回终点的格子下标，不可达返回 -1
+    template <typename Walkable>
+    int search(Point start, Point goal, Walkable&& walkable) {
+        if (start.x < 0 || start.x >= width || start.y < 0 || start.y >= height) return -1;
+        if (goal.x < 0 || goal.x >= width || goal.y < 0 || goal.y >= height) return -1;
+        if (!walkable(start.x, start.y) || !walkable(goal.x, goal.y)) return -1;
+
+        nextGeneration();
+        int startCell = start.y * width + start.x;
+        int goalCell = goal.y * width + goal.x;
+
+        seenStamp[startCell] = generation;
+        gScore[startCell] = 0;
+        fScore[startCell] = heuristic(startCell, goal.x, goal.y);
+        parent[startCell] = -1;
+        heap.push_back(startCell);
+        heapPos[startCell] = 0;
+
+        const int dirs[4][2] = {{0, 1}, {0, -1}, {1, 0}, {-1, 0}};
+
+        while (!heap.empty()) {
+            int curr = popMin();
+            if (curr == goalCell) return curr;
+            closedStamp[curr] = generation;
+
+            int cx = curr % width;
+            int cy = curr / width;
+            for (const auto& dir : dirs) {
+                int nx = cx + dir[0];
+                int ny = cy + dir[1];
+                if (nx < 0 || nx >= width || ny < 0 || ny >= height) continue;
+                int next = ny * width + nx;
+                if (closedStamp[next] == generation || !walkable(nx, ny)) continue;
+
+                int g = gScore[curr] + 1;
+                if (seenStamp[next] != generation) {
+                    seenStamp[next] = generation;
+                    gScore[next] = g;
+                    fScore[next] = g + heuristic(next, goal.x, goal.y);
+                    parent[next] = curr;
+                    heap.push_back(next);
+                    siftUp(static_cast<int>(heap.size()) - 1);
+                } else if (g < gScore[next]) {
+                    // 找到更短的路：decrease-key
+                    gScore[next] = g;
+                    fScore[next] = g + heuristic(next, goal.x, goal.y);
+                    parent[next] = curr;
+                    siftUp(heapPos[next]);
+                }
+            }
+        }
+        return -1;
+    }
+
+public:
+    // 地图尺寸变化时重新分配缓冲区（每张地图只发生一次）
+    void resize(int w, int h) {
+        if (w == width && h == height) return;
+        width = w;
+        height = h;
+        size_t cells = static_cast<size_t>(w) * h;
+        seenStamp.assign(cells, 0u);
+        closedStamp.assign(cells, 0u);
+        gScore.assign(cells, 0);
+        fScore.assign(cells, 0);
+        parent.assign(cells, -1);
+        heapPos.assign(cells, 0);
+        heap.clear();
+        heap.reserve(cells);
+        generation = 0;
+    }
+
+    // 最短步数，不可达返回 -1
+    template <typename Walkable>
+    int distance(Point start, Point goal, Walkable&& walkable) {
+        int end = search(start, goal, walkable);
+        return end < 0 ? -1 : gScore[end];
+    }
+
+    // 完整路径：outPath 依次为每一步要走到的格子（不含起点，含终点）
+    // outPath 由调用者持有，容量足够时不会重新分配
+    template <typename Walkable>
+    int findPath(Point start, Point goal, Walkable&& walkable, std::vector<Point>& outPath) {
+        outPath.clear();
+        int end = search(start, goal, walkable);
+        if (end < 0) return -1;
+
+        int steps = gScore[end];
+        outPath.resize(steps);
+        for (int cell = end, i = steps - 1; i >= 0; cell = parent[cell], --i) {
+            outPath[i] = {cell % width, cell / width};
+        }
+        return steps;
+    }
+};
+
+#endif // PATHFINDER_H
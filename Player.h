@@ -2,22 +2,51 @@
 #define PLAYER_H
 
 #include "Creature.h"
-#include "Input.h"
+#include "ActionSource.h"
 
 class Player : public Creature {
 private:
     int level;
     int exp;
+    ActionSource* source; // 【新增】行动来源：键盘或自动机器人（由 Game 设置）
+    bool quitRequested;   // 【新增】玩家按了 Q 或连接已断开
+    bool undoRequested;   // 【新增】玩家按了 U（调试用：撤销上一回合）
 
 public:
     Player(int x, int y) 
-        : Creature(x, y, "@", "Hero", 100, 10, 2, Color::GREEN), level(1), exp(0) {}
+        : Creature(x, y, "@", "Hero", 100, 10, 2, Color::GREEN), level(1), exp(0),
+          source(nullptr), quitRequested(false), undoRequested(false) {}
+
+    void setActionSource(ActionSource* s) { source = s; }
+    bool hasQuit() const { return quitRequested; }
+
+    // 【新增】取走撤销请求（只生效一次）
+    bool takeUndoRequest() {
+        bool requested = undoRequested;
+        undoRequested = false;
+        return requested;
+    }
+
+    CreatureKind kind() const override { return CreatureKind::HERO; }
+
+    void saveState(CreatureRecord& r) const override {
+        Creature::saveState(r);
+        r.extra[0] = level;
+        r.extra[1] = exp;
+    }
+
+    void loadState(const CreatureRecord& r) override {
+        Creature::loadState(r);
+        level = r.extra[0];
+        exp = r.extra[1];
+    }
 
     // 实现多态方法 onTurn
     // 修改 onTurn 方法：
 
-    void onTurn(Map& map, std::vector<Creature*>& others) override {
-        char input = Input::get();
+    void onTurn(Map& map, std::vector<Creature*>& others, Rng& /*rng*/) override {
+        if (!source) return;
+        char input = source->nextAction(map, *this, others);
         int dx = 0, dy = 0;
 
         switch (std::toupper(input)) {
@@ -25,7 +54,9 @@ public:
             case 'S': dy = 1; break;
             case 'A': dx = -1; break;
             case 'D': dx = 1; break;
-            case 'Q': exit(0); break;
+            // 【修改】不再直接 exit(0)：服务器上还有其他玩家，由 Game 负责收尾
+            case 'Q': quitRequested = true; return;
+            case 'U': undoRequested = true; return; // 【新增】由 Game 回滚到上一回合
             default: return; // 无效按键，回合不消耗（或者消耗，看设计）
         }
 
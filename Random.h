@@ -0,0 +1,32 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// 每局游戏独立的随机数发生器（SplitMix64）
+// 全局的 rand() 在多线程下共享同一个状态，同一个种子也无法复现同一局游戏；
+// 这里的状态只有 8 字节，可以随存档 / 快照一起复制
+class Rng {
+private:
+    uint64_t state;
+
+public:
+    explicit Rng(uint64_t seed = 0) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // [0, n) 范围内的整数，n 必须大于 0
+    int nextInt(int n) {
+        return static_cast<int>((next() >> 32) % static_cast<uint64_t>(n));
+    }
+
+    uint64_t getState() const { return state; }
+    void setState(uint64_t s) { state = s; }
+};
+
+#endif // RANDOM_H
@@ -0,0 +1,101 @@
+#ifndef RENDERTHREAD_H
+#define RENDERTHREAD_H
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Frame.h"
+#include "GameIO.h"
+#include "MemoryStats.h"
+
+// 独立的渲染线程 + 三重缓冲
+// 游戏线程每回合把画面 publish 进"后台"缓冲区，再和"中间"缓冲区原子交换，从不等待输出；
+// 渲染线程从"中间"换出最新的一帧，清屏并写入终端 / 套接字
+// 终端很慢时，渲染线程来不及取走的中间帧直接被下一帧覆盖（丢帧），回合推进不受影响
+//
+// 注意：渲染线程工作期间，游戏线程不能直接向 io 输出；
+// 在 gameLoop 之外输出（剧情、菜单、结算画面）之前必须先调用 waitIdle()
+class RenderThread : public FrameSink {
+private:
+    static const int FRESH = 4;      // 中间缓冲区里是一帧还没画过的新画面
+    static const int INDEX_MASK = 3;
+
+    GameIO& io;
+    Frame buffers[3];
+    int back = 0;                    // 只由游戏线程使用
+    std::atomic<int> middle{1};      // 缓冲区编号 | FRESH
+    int front = 2;                   // 只由渲染线程使用
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool rendering = false;
+    bool stopping = false;
+    std::atomic<long> dropped{0};
+    std::thread worker;
+
+    bool hasFresh() const { return (middle.load(std::memory_order_acquire) & FRESH) != 0; }
+
+    void loop() {
+        Memory::Scope tag(Memory::RENDER);
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [this] { return stopping || hasFresh(); });
+                if (!hasFresh()) return; // stopping
+                rendering = true;
+            }
+
+            // 取走最新的一帧，把画完的旧缓冲区还回去
+            front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+            {
+                std::lock_guard<std::mutex> output(io.outputMutex());
+                io.clearScreen();
+                buffers[front].render(io.out());
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            rendering = false;
+            changed.notify_all();
+        }
+    }
+
+public:
+    explicit RenderThread(GameIO& endpoint) : io(endpoint) {}
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    ~RenderThread() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            changed.notify_all();
+        }
+        if (worker.joinable()) worker.join();
+    }
+
+    // 游戏线程调用：复制一帧进后台缓冲区，立即返回
+    void publish(const Frame& frame) override {
+        if (!worker.joinable()) worker = std::thread(&RenderThread::loop, this);
+        buffers[back] = frame; // 复用缓冲区的容量，稳定后不再分配
+        int previous = middle.exchange(back | FRESH, std::memory_order_acq_rel);
+        if (previous & FRESH) dropped.fetch_add(1, std::memory_order_relaxed);
+        back = previous & INDEX_MASK;
+
+        // 先拿一下锁再通知，避免渲染线程刚检查完条件、还没睡下时错过这次唤醒
+        { std::lock_guard<std::mutex> lock(mutex); }
+        changed.notify_one();
+    }
+
+    // 阻塞直到已发布的画面全部画完（游戏线程直接输出之前调用）
+    void waitIdle() {
+        if (!worker.joinable()) return;
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return !rendering && !hasFresh(); });
+    }
+
+    // 因为终端太慢而被跳过的帧数
+    long droppedFrames() const { return dropped.load(std::memory_order_relaxed); }
+};
+
+#endif // RENDERTHREAD_H
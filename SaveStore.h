@@ -0,0 +1,391 @@
+#ifndef SAVESTORE_H
+#define SAVESTORE_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <map>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <type_traits>
+#include "SaveWriter.h"
+
+#ifdef _WIN32
+    #include <io.h>
+    #include <fcntl.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/file.h>
+#endif
+
+// 槽位的摘要信息（菜单上显示的内容），明文存在索引里，不需要读取和解密存档本身
+struct SaveSlotInfo {
+    int32_t slot = 0;
+    int32_t level = 0;
+    int32_t difficulty = 0;
+    int32_t mode = 0;
+    int64_t savedAt = 0; // time(0)；0 表示时间未知（从旧版存档导入）
+};
+
+// 单文件存档容器：所有槽位都存在 saves/saves.dat 里，槽位数量不限
+//
+//   [文件头] magic | version | indexOffset | count
+//   [存档数据] [存档数据] ... [索引] [存档数据] [索引] ...
+//
+// 写入一个槽位时：把新数据和一份新的完整索引追加到文件末尾，fsync，最后覆盖文件头指向新索引再 fsync
+// 文件头只有 24 字节，一次写入即可完成；崩溃时文件头要么指向旧索引、要么指向新索引，其他槽位不受影响
+// 被替换掉的旧数据和旧索引留在文件里，积累得比有效数据还多时整体重写一次（临时文件 + rename）
+//
+// 菜单列出槽位只需读文件头和索引两次小读取
+// 所有操作都由内部的锁串行化：后台存档线程写入、游戏线程列出 / 读取可以同时发生
+// 【修改】同一个文件在进程内只有一个实例（forPath），服务器模式下多个会话共用同一把锁；
+// 另外在 POSIX 上对 "<文件>.lock" 加 flock，多个游戏进程同时读写、整理同一个容器也不会互相覆盖
+class SaveStore {
+private:
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint64_t indexOffset; // 0 表示还没有任何槽位
+        uint32_t count;
+        uint32_t reserved;
+    };
+
+    struct IndexEntry {
+        SaveSlotInfo info;
+        uint64_t offset;
+        uint32_t length;
+        uint32_t checksum; // 存档数据的 FNV-1a，读取时校验
+    };
+
+    static_assert(std::is_trivially_copyable<IndexEntry>::value, "索引项按原样写入文件");
+
+    static constexpr char MAGIC[4] = {'D', 'L', 'S', 'V'};
+    static const uint32_t VERSION = 1;
+    static const uint32_t MAX_SLOTS = 100000; // 防止损坏的文件头让我们分配大量内存
+
+    std::string path;
+    std::mutex mutex;
+
+    // 跨进程的文件锁：持有期间其他进程的读写和整理都要等待（Windows 上只靠进程内的互斥锁）
+    // 目录还不存在时拿不到锁文件，这时也还没有容器可读；写入前会先建好目录
+    class FileLock {
+    private:
+        int fd = -1;
+
+    public:
+        explicit FileLock(const std::string& file) {
+            #ifndef _WIN32
+                fd = ::open((file + ".lock").c_str(), O_RDWR | O_CREAT, 0644);
+                while (fd >= 0 && flock(fd, LOCK_EX) != 0 && errno == EINTR) {}
+            #else
+                (void)file;
+            #endif
+        }
+        ~FileLock() {
+            #ifndef _WIN32
+                if (fd >= 0) ::close(fd); // 关闭即释放 flock
+            #endif
+        }
+        FileLock(const FileLock&) = delete;
+        FileLock& operator=(const FileLock&) = delete;
+    };
+
+    static uint32_t checksum(const std::string& data) {
+        uint32_t h = 2166136261u;
+        for (unsigned char c : data) h = (h ^ c) * 16777619u;
+        return h;
+    }
+
+    static Header emptyHeader() {
+        Header h{};
+        std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+        h.version = VERSION;
+        return h;
+    }
+
+    // --- 底层文件操作（Windows 没有 pread / pwrite，统一用 seek + read / write） ---
+
+    static bool seekTo(int fd, uint64_t offset) {
+        #ifdef _WIN32
+            return _lseeki64(fd, static_cast<__int64>(offset), SEEK_SET) >= 0;
+        #else
+            return lseek(fd, static_cast<off_t>(offset), SEEK_SET) >= 0;
+        #endif
+    }
+
+    static bool seekEnd(int fd, uint64_t& offset) {
+        #ifdef _WIN32
+            __int64 end = _lseeki64(fd, 0, SEEK_END);
+        #else
+            off_t end = lseek(fd, 0, SEEK_END);
+        #endif
+        if (end < 0) return false;
+        offset = static_cast<uint64_t>(end);
+        return true;
+    }
+
+    static bool readAll(int fd, void* buffer, size_t size) {
+        char* p = static_cast<char*>(buffer);
+        while (size > 0) {
+            #ifdef _WIN32
+                int n = _read(fd, p, static_cast<unsigned>(size));
+            #else
+                ssize_t n = ::read(fd, p, size);
+            #endif
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            p += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    static bool writeAll(int fd, const void* buffer, size_t size) {
+        const char* p = static_cast<const char*>(buffer);
+        while (size > 0) {
+            #ifdef _WIN32
+                int n = _write(fd, p, static_cast<unsigned>(size));
+            #else
+                ssize_t n = ::write(fd, p, size);
+            #endif
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            p += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    static bool syncFile(int fd) {
+        #ifdef _WIN32
+            return _commit(fd) == 0;
+        #else
+            return fsync(fd) == 0;
+        #endif
+    }
+
+    static void closeFile(int fd) {
+        #ifdef _WIN32
+            _close(fd);
+        #else
+            ::close(fd);
+        #endif
+    }
+
+    int openFile(bool writable) const {
+        #ifdef _WIN32
+            return _open(path.c_str(), (writable ? _O_RDWR : _O_RDONLY) | _O_BINARY);
+        #else
+            return ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+        #endif
+    }
+
+    // 读取文件头和索引；文件不存在时返回空索引
+    bool loadIndex(int fd, std::vector<IndexEntry>& index, std::string& error) const {
+        index.clear();
+        Header h;
+        if (!seekTo(fd, 0) || !readAll(fd, &h, sizeof(h))) {
+            error = "存档文件 " + path + " 读取失败";
+            return false;
+        }
+        if (std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0 || h.version != VERSION || h.count > MAX_SLOTS) {
+            error = "存档文件 " + path + " 格式不正确";
+            return false;
+        }
+        if (h.count == 0) return true;
+        index.resize(h.count);
+        if (!seekTo(fd, h.indexOffset) || !readAll(fd, index.data(), index.size() * sizeof(IndexEntry))) {
+            error = "存档文件 " + path + " 的索引已损坏";
+            index.clear();
+            return false;
+        }
+        return true;
+    }
+
+    // 在末尾追加新索引，再让文件头指向它
+    bool commitIndex(int fd, const std::vector<IndexEntry>& index, std::string& error) const {
+        uint64_t offset = 0;
+        bool ok = seekEnd(fd, offset)
+               && writeAll(fd, index.data(), index.size() * sizeof(IndexEntry))
+               && syncFile(fd); // 先让数据和索引落盘，文件头才能指过去
+
+        Header h = emptyHeader();
+        h.indexOffset = index.empty() ? 0 : offset;
+        h.count = static_cast<uint32_t>(index.size());
+        ok = ok && seekTo(fd, 0) && writeAll(fd, &h, sizeof(h)) && syncFile(fd);
+        if (!ok) error = "写入 " + path + " 失败: " + std::strerror(errno);
+        return ok;
+    }
+
+    // 文件不存在时创建一个只有文件头的空容器（调用者持有两把锁，不会有两个写入者同时创建）
+    bool ensureFile(std::string& error) const {
+        int fd = openFile(false);
+        if (fd >= 0) {
+            closeFile(fd);
+            return true;
+        }
+        Header h = emptyHeader();
+        return SaveWriter::writeAtomically(path, std::string(reinterpret_cast<const char*>(&h), sizeof(h)), error);
+    }
+
+    // 旧数据太多时，把有效的槽位整体重写到新文件（同样是临时文件 + rename）
+    // 调用前必须先关闭写入用的句柄（Windows 上无法替换仍然打开着的文件）
+    // 调用者持有两把锁：其他会话和进程每次操作都重新打开文件，不会拿着被替换掉的旧文件继续写
+    void compactIfWasteful(const std::vector<IndexEntry>& index) const {
+        int fd = openFile(false);
+        if (fd < 0) return;
+        uint64_t size = 0;
+        if (!seekEnd(fd, size)) size = 0;
+        uint64_t live = sizeof(Header) + index.size() * sizeof(IndexEntry);
+        for (const auto& e : index) live += e.length;
+        if (size <= 2 * live + 4096) {
+            closeFile(fd);
+            return;
+        }
+
+        std::vector<IndexEntry> packed = index;
+        std::string image(sizeof(Header), '\0');
+        bool ok = true;
+        for (auto& e : packed) {
+            std::string payload(e.length, '\0');
+            ok = ok && seekTo(fd, e.offset) && (e.length == 0 || readAll(fd, &payload[0], payload.size()));
+            e.offset = image.size();
+            image += payload;
+        }
+        closeFile(fd);
+        if (!ok) return;
+        Header h = emptyHeader();
+        h.indexOffset = packed.empty() ? 0 : image.size();
+        h.count = static_cast<uint32_t>(packed.size());
+        std::memcpy(&image[0], &h, sizeof(h));
+        image.append(reinterpret_cast<const char*>(packed.data()), packed.size() * sizeof(IndexEntry));
+
+        std::string ignored; // 整理失败不影响已经提交的写入，下次再试
+        SaveWriter::writeAtomically(path, image, ignored);
+    }
+
+public:
+    explicit SaveStore(std::string file) : path(std::move(file)) {}
+    SaveStore(const SaveStore&) = delete;
+    SaveStore& operator=(const SaveStore&) = delete;
+
+    // 【新增】取得某个文件对应的共享实例：同一进程里打开同一个容器的所有游戏都用它，读写才能互相串行
+    static std::shared_ptr<SaveStore> forPath(const std::string& file) {
+        static std::mutex registryMutex;
+        static std::map<std::string, std::weak_ptr<SaveStore>> registry;
+        std::lock_guard<std::mutex> lock(registryMutex);
+        std::shared_ptr<SaveStore> store = registry[file].lock();
+        if (!store) {
+            store = std::make_shared<SaveStore>(file);
+            registry[file] = store;
+        }
+        return store;
+    }
+
+    // 所有槽位的摘要（按槽位号排列）；文件不存在或损坏时返回空
+    std::vector<SaveSlotInfo> list() {
+        std::lock_guard<std::mutex> lock(mutex);
+        FileLock fileLock(path);
+        std::vector<SaveSlotInfo> slots;
+        int fd = openFile(false);
+        if (fd < 0) return slots;
+        std::vector<IndexEntry> index;
+        std::string error;
+        if (loadIndex(fd, index, error)) {
+            for (const auto& e : index) slots.push_back(e.info);
+        }
+        closeFile(fd);
+        return slots;
+    }
+
+    bool contains(int slot) {
+        for (const auto& s : list()) {
+            if (s.slot == slot) return true;
+        }
+        return false;
+    }
+
+    // 读取一个槽位的存档数据；没有这个槽位时 error 为空
+    bool read(int slot, std::string& payload, std::string& error) {
+        std::lock_guard<std::mutex> lock(mutex);
+        FileLock fileLock(path);
+        error.clear();
+        int fd = openFile(false);
+        if (fd < 0) return false;
+        std::vector<IndexEntry> index;
+        bool ok = loadIndex(fd, index, error);
+        bool found = false;
+        for (size_t i = 0; ok && i < index.size(); ++i) {
+            const IndexEntry& e = index[i];
+            if (e.info.slot != slot) continue;
+            found = true;
+            payload.assign(e.length, '\0');
+            ok = seekTo(fd, e.offset) && (e.length == 0 || readAll(fd, &payload[0], e.length))
+              && checksum(payload) == e.checksum;
+            if (!ok) error = "槽位 " + std::to_string(slot) + " 的数据已损坏";
+        }
+        closeFile(fd);
+        return ok && found;
+    }
+
+    // 写入（或覆盖）一个槽位，其他槽位的数据原封不动
+    bool write(const SaveSlotInfo& info, const std::string& payload, std::string& error) {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t slash = path.find_last_of("/\\");
+        if (slash != std::string::npos && !SaveWriter::makeDirectory(path.substr(0, slash), error)) return false;
+        FileLock fileLock(path);
+        if (!ensureFile(error)) return false;
+        int fd = openFile(true);
+        if (fd < 0) {
+            error = "无法打开 " + path + ": " + std::strerror(errno);
+            return false;
+        }
+
+        std::vector<IndexEntry> index;
+        uint64_t offset = 0;
+        bool ok = loadIndex(fd, index, error);
+        if (ok && !(seekEnd(fd, offset) && writeAll(fd, payload.data(), payload.size()))) {
+            error = "写入 " + path + " 失败: " + std::strerror(errno);
+            ok = false;
+        }
+        if (ok) {
+            IndexEntry entry{info, offset, static_cast<uint32_t>(payload.size()), checksum(payload)};
+            size_t i = 0;
+            while (i < index.size() && index[i].info.slot < info.slot) ++i;
+            if (i < index.size() && index[i].info.slot == info.slot) index[i] = entry;
+            else index.insert(index.begin() + i, entry);
+            ok = commitIndex(fd, index, error);
+        }
+        closeFile(fd);
+        if (ok) compactIfWasteful(index);
+        return ok;
+    }
+
+    // 删除一个槽位（没有这个槽位也算成功）
+    bool remove(int slot, std::string& error) {
+        std::lock_guard<std::mutex> lock(mutex);
+        FileLock fileLock(path);
+        int fd = openFile(true);
+        if (fd < 0) return true; // 还没有存档文件
+        std::vector<IndexEntry> index;
+        bool ok = loadIndex(fd, index, error);
+        size_t before = index.size();
+        if (ok) {
+            for (size_t i = 0; i < index.size(); ++i) {
+                if (index[i].info.slot == slot) {
+                    index.erase(index.begin() + i);
+                    break;
+                }
+            }
+        }
+        if (ok && index.size() != before) ok = commitIndex(fd, index, error);
+        closeFile(fd);
+        if (ok) compactIfWasteful(index);
+        return ok;
+    }
+};
+
+#endif // SAVESTORE_H
@@ -0,0 +1,211 @@
+#ifndef SAVEWRITER_H
+#define SAVEWRITER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <functional>
+#include "MemoryStats.h"
+
+#ifdef _WIN32
+    #include <direct.h>
+    #include <process.h>
+    #include <io.h>
+    #include <fcntl.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/stat.h>
+#endif
+
+// 后台存档写入器
+// 游戏线程只负责把存档序列化成字节串，真正的磁盘操作在后台线程完成
+// 【修改】队列里排的是任务（例如写入 / 删除 SaveStore 的某个槽位），按提交顺序依次执行，
+// 写入和删除的先后顺序与游戏里一致
+// writeAtomically 供 SaveStore 创建和整理容器时使用：
+//   1. 用系统调用直接创建存档目录（不再 system("mkdir -p") 启动 shell）
+//   2. 写入临时文件并 fsync
+//   3. rename 原子替换正式文件，再 fsync 所在目录让这次改名本身落盘 ——
+//      崩溃时要么是旧文件，要么是新文件，不会出现写了一半的文件
+class SaveWriter {
+public:
+    // 一次操作的结果，由游戏线程通过 takeResults() 取回并显示
+    struct Result {
+        int tag;            // 调用者自定义（例如槽位号）
+        bool isRemove;
+        bool ok;
+        std::string error;
+    };
+
+private:
+    struct Job {
+        bool isRemove;
+        int tag;
+        std::function<bool(std::string&)> task;
+    };
+
+    std::deque<Job> jobs;
+    std::vector<Result> results;
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool busy = false;
+    bool stopping = false;
+    std::thread worker;
+
+public:
+    // 【修改】公开给 SaveStore 复用：建目录、写临时文件、fsync、rename（在调用者的线程里同步完成）
+    // 和原来的 mkdir -p 一样，缺少的上级目录会逐级创建
+    static bool makeDirectory(const std::string& dir, std::string& error) {
+        size_t slash = dir.find_last_of("/\\");
+        if (slash != std::string::npos && slash > 0 && dir[slash - 1] != ':' && !makeDirectory(dir.substr(0, slash), error)) return false;
+        #ifdef _WIN32
+            int rc = _mkdir(dir.c_str());
+        #else
+            int rc = mkdir(dir.c_str(), 0755);
+        #endif
+        if (rc == 0 || errno == EEXIST) return true;
+        error = "无法创建目录 " + dir + ": " + std::strerror(errno);
+        return false;
+    }
+
+    static bool writeAtomically(const std::string& path, const std::string& data, std::string& error) {
+        size_t slash = path.find_last_of("/\\");
+        if (slash != std::string::npos && !makeDirectory(path.substr(0, slash), error)) return false;
+
+        // 【修改】临时文件名带上进程号和序号：多个线程或进程同时替换同一个文件时不会写进同一个临时文件
+        static std::atomic<unsigned> tempCounter{0};
+        #ifdef _WIN32
+            int pid = _getpid();
+        #else
+            int pid = static_cast<int>(getpid());
+        #endif
+        std::string temp = path + ".tmp." + std::to_string(pid) + "." + std::to_string(tempCounter++);
+        #ifdef _WIN32
+            int fd = _open(temp.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0644);
+        #else
+            int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        #endif
+        if (fd < 0) {
+            error = "无法创建 " + temp + ": " + std::strerror(errno);
+            return false;
+        }
+
+        size_t written = 0;
+        bool ok = true;
+        while (written < data.size()) {
+            #ifdef _WIN32
+                int n = _write(fd, data.data() + written, static_cast<unsigned>(data.size() - written));
+            #else
+                ssize_t n = write(fd, data.data() + written, data.size() - written);
+            #endif
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                ok = false;
+                break;
+            }
+            written += n;
+        }
+
+        #ifdef _WIN32
+            ok = ok && _commit(fd) == 0;
+            ok = (_close(fd) == 0) && ok;
+            // Windows 的 rename 不能覆盖已有文件，只能先删除（这一步不是原子的）
+            if (ok) std::remove(path.c_str());
+        #else
+            ok = ok && fsync(fd) == 0;
+            ok = (close(fd) == 0) && ok;
+        #endif
+
+        if (!ok || std::rename(temp.c_str(), path.c_str()) != 0) {
+            error = "写入 " + path + " 失败: " + std::strerror(errno);
+            std::remove(temp.c_str());
+            return false;
+        }
+
+        #ifndef _WIN32
+            // rename 只改了目录项：目录本身也 fsync 之后，断电重启才一定能看到新文件
+            std::string dir = (slash == std::string::npos) ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+            int dirFd = open(dir.c_str(), O_RDONLY);
+            if (dirFd < 0 || fsync(dirFd) != 0) {
+                error = "同步目录 " + dir + " 失败: " + std::strerror(errno);
+                if (dirFd >= 0) close(dirFd);
+                return false;
+            }
+            close(dirFd);
+        #endif
+        return true;
+    }
+
+private:
+    void loop() {
+        Memory::Scope tag(Memory::SAVE);
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            changed.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty()) return; // stopping 且队列已清空
+
+            Job job = std::move(jobs.front());
+            jobs.pop_front();
+            busy = true;
+            lock.unlock();
+
+            Result result{job.tag, job.isRemove, true, ""};
+            result.ok = job.task(result.error);
+
+            lock.lock();
+            busy = false;
+            results.push_back(result);
+            changed.notify_all();
+        }
+    }
+
+    void enqueue(Job job) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!worker.joinable()) worker = std::thread(&SaveWriter::loop, this);
+        jobs.push_back(std::move(job));
+        changed.notify_all();
+    }
+
+public:
+    SaveWriter() = default;
+    SaveWriter(const SaveWriter&) = delete;
+    SaveWriter& operator=(const SaveWriter&) = delete;
+
+    // 退出前把队列里的存档全部写完
+    ~SaveWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            changed.notify_all();
+        }
+        if (worker.joinable()) worker.join();
+    }
+
+    // 【修改】排入一个任务：返回 false 时把 error 作为失败原因报告
+    void submitTask(std::function<bool(std::string&)> task, bool isRemove, int tag = 0) {
+        enqueue({isRemove, tag, std::move(task)});
+    }
+
+    // 阻塞直到队列清空（读档前调用，保证读到的是最新存档）
+    void waitIdle() {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return jobs.empty() && !busy; });
+    }
+
+    // 取走已完成的操作结果（非阻塞）
+    std::vector<Result> takeResults() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<Result> done;
+        done.swap(results);
+        return done;
+    }
+};
+
+#endif // SAVEWRITER_H
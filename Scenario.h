@@ -0,0 +1,111 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <iostream>
+#include <iomanip>
+
+// 压力测试场景：地图尺寸、墙壁密度、史莱姆 / 巨龙 / 物品数量都可以随意指定，
+// 远超 Game::initLevel 会生成的规模，用来测碰撞、怪物 AI、画面构建和拾取在最坏情况下的耗时
+struct ScenarioConfig {
+    std::string name = "custom";
+    int width = 60;
+    int height = 25;
+    float wallDensity = 0.1f; // 内部格子变成墙的比例
+    int slimes = 0;
+    int dragons = 0;
+    int potions = 0;
+    int swords = 0;
+    int turns = 200;          // 最多跑这么多回合（走到出口或死亡会提前结束）
+    uint64_t seed = 12345;
+
+    // 超大地图：1000x1000，5 万只怪物
+    static ScenarioConfig huge() {
+        ScenarioConfig c;
+        c.name = "huge";
+        c.width = 1000;
+        c.height = 1000;
+        c.wallDensity = 0.1f;
+        c.slimes = 48000;
+        c.dragons = 2000;
+        c.potions = 200;
+        c.swords = 20;
+        c.turns = 50;
+        return c;
+    }
+
+    // 挤满的竞技场：60x25（initLevel 的最大尺寸），几乎每个空格子上都有怪物或物品
+    static ScenarioConfig arena() {
+        ScenarioConfig c;
+        c.name = "arena";
+        c.width = 60;
+        c.height = 25;
+        c.wallDensity = 0.05f;
+        c.slimes = 1000;
+        c.dragons = 50;
+        c.potions = 80;
+        c.swords = 40;
+        c.turns = 500;
+        return c;
+    }
+};
+
+// 各阶段的累计耗时（毫秒）
+struct PhaseTimes {
+    enum Phase { GENERATE, SPAWN, PLAYER, PICKUP, AI, CLEANUP, RENDER, PHASE_COUNT };
+
+    double ms[PHASE_COUNT] = {};
+
+    static const char* name(int phase) {
+        static const char* names[PHASE_COUNT] = {"地图生成", "放置物体", "玩家行动", "物品拾取", "怪物回合", "清理尸体", "画面构建"};
+        return names[phase];
+    }
+};
+
+// 计时作用域：times 为空时什么也不做（正常游戏不开启计时）
+class PhaseClock {
+private:
+    PhaseTimes* times;
+    int phase;
+    std::chrono::steady_clock::time_point begin;
+
+public:
+    PhaseClock(PhaseTimes* t, int p) : times(t), phase(p) {
+        if (times) begin = std::chrono::steady_clock::now();
+    }
+    ~PhaseClock() {
+        if (times) times->ms[phase] += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    }
+    PhaseClock(const PhaseClock&) = delete;
+    PhaseClock& operator=(const PhaseClock&) = delete;
+};
+
+// 一次场景运行的结果
+struct ScenarioReport {
+    ScenarioConfig config;
+    PhaseTimes times;
+    int turns = 0;
+    int enemiesAtStart = 0;
+    int enemiesAtEnd = 0;
+    int itemsAtStart = 0;
+    int itemsAtEnd = 0;
+    bool reachedExit = false;
+
+    void print(std::ostream& os) const {
+        os << "== 场景 " << config.name << " | " << config.width << "x" << config.height
+           << " | 墙壁 " << static_cast<int>(config.wallDensity * 100) << "% ==" << std::endl;
+        os << "怪物 " << enemiesAtStart << " -> " << enemiesAtEnd << " | 物品 " << itemsAtStart << " -> " << itemsAtEnd
+           << " | 回合 " << turns << (reachedExit ? "（到达出口）" : "") << std::endl;
+        os << std::fixed << std::setprecision(3);
+        for (int p = 0; p < PhaseTimes::PHASE_COUNT; ++p) {
+            os << PhaseTimes::name(p) << std::setw(12) << times.ms[p] << " ms";
+            if (p >= PhaseTimes::PLAYER && turns > 0) os << std::setw(12) << times.ms[p] / turns << " ms/回合";
+            os << std::endl;
+        }
+        os.unsetf(std::ios::fixed);
+    }
+};
+
+#endif // SCENARIO_H
@@ -0,0 +1,194 @@
+#ifndef SEQUENCE_H
+#define SEQUENCE_H
+
+#include <coroutine>
+#include <chrono>
+#include <thread>
+#include <deque>
+#include <functional>
+#include <exception>
+#include <utility>
+#include "GameIO.h"
+
+// 基于 C++20 协程的非阻塞演出序列（剧情打字机、过关停顿、读档提示……）
+// 序列里用 co_await Pause{毫秒} 停顿、co_await WaitKey{} 等待按键，
+// 由 Scheduler 在主循环里推进：
+//   - 停顿期间主线程不睡死，而是去执行排队的后台任务（例如生成下一层地图）
+//   - 停顿期间玩家按任意键，本序列剩余的所有停顿立即跳过
+// 序列可以 co_await 另一个序列（例如剧情里调用打字机）
+
+// 一次 Scheduler::run 的共享状态，嵌套的子序列共用同一份
+struct SequenceState {
+    std::coroutine_handle<> leaf;   // 当前挂起的最内层协程，调度器恢复它
+    std::chrono::steady_clock::time_point wakeAt{};
+    bool waitingForKey = false;
+    bool skipping = false;          // 玩家按键跳过：之后的 Pause 立即返回
+};
+
+class Sequence {
+public:
+    struct promise_type {
+        SequenceState* state = nullptr;
+        std::coroutine_handle<> parent; // co_await 本序列的上层协程
+
+        Sequence get_return_object() {
+            return Sequence(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        // 结束时直接切回上层协程（对称转移），没有上层就交还给调度器
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                std::coroutine_handle<> parent = h.promise().parent;
+                if (parent) {
+                    h.promise().state->leaf = parent;
+                    return parent;
+                }
+                return std::noop_coroutine();
+            }
+            void await_resume() noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    explicit Sequence(Handle h) : handle(h) {}
+    Sequence(Sequence&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Sequence& operator=(Sequence&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    Sequence(const Sequence&) = delete;
+    Sequence& operator=(const Sequence&) = delete;
+    ~Sequence() {
+        if (handle) handle.destroy();
+    }
+
+    bool done() const { return !handle || handle.done(); }
+
+    // 在一个序列里 co_await 另一个序列：立即开始执行子序列，结束后回到这里
+    bool await_ready() const noexcept { return done(); }
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> caller) noexcept {
+        handle.promise().state = caller.promise().state;
+        handle.promise().parent = caller;
+        handle.promise().state->leaf = handle;
+        return handle;
+    }
+    void await_resume() const noexcept {}
+
+    // 由 Scheduler 启动根序列
+    void start(SequenceState& state) {
+        handle.promise().state = &state;
+        state.leaf = handle;
+        handle.resume();
+    }
+
+private:
+    Handle handle;
+};
+
+// 停顿若干毫秒（可被按键跳过）
+struct Pause {
+    int ms;
+
+    bool await_ready() const noexcept { return ms <= 0; }
+    bool await_suspend(Sequence::Handle h) {
+        SequenceState* state = h.promise().state;
+        if (state->skipping) return false; // 已跳过：不挂起，直接继续
+        state->leaf = h;
+        state->wakeAt = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+        return true;
+    }
+    void await_resume() const noexcept {}
+};
+
+// 等待玩家按下任意键（不可跳过）
+struct WaitKey {
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(Sequence::Handle h) {
+        SequenceState* state = h.promise().state;
+        state->leaf = h;
+        state->waitingForKey = true;
+    }
+    void await_resume() const noexcept {}
+};
+
+// 在主循环里推进序列，并利用停顿时间执行后台任务
+class Scheduler {
+private:
+    GameIO& io;
+    std::deque<std::function<void()>> background;
+
+    void runAllBackground() {
+        while (!background.empty()) runOneBackground();
+    }
+
+    void runOneBackground() {
+        std::function<void()> task = std::move(background.front());
+        background.pop_front();
+        task();
+    }
+
+public:
+    explicit Scheduler(GameIO& endpoint) : io(endpoint) {}
+
+    // 排一个后台任务：会在下一个序列的停顿里执行，最晚在序列结束前执行完
+    void runInBackground(std::function<void()> task) {
+        background.push_back(std::move(task));
+    }
+
+    // 执行一个序列直到结束
+    void run(Sequence seq) {
+        SequenceState state;
+        // 无人值守时没有停顿
+        state.skipping = !io.isInteractive();
+        seq.start(state);
+
+        while (!seq.done()) {
+            if (state.waitingForKey) {
+                // 等玩家看完之前，先把后台任务做完
+                runAllBackground();
+                io.get();
+                state.waitingForKey = false;
+                state.skipping = !io.isInteractive(); // 新的一段重新开始计算停顿
+                state.leaf.resume();
+                continue;
+            }
+
+            if (io.hasPending()) {
+                io.clearBuffer();
+                state.skipping = true;
+                state.leaf.resume();
+                continue;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (state.skipping || now >= state.wakeAt) {
+                state.leaf.resume();
+                continue;
+            }
+
+            if (!background.empty()) {
+                runOneBackground();
+                continue;
+            }
+
+            auto remaining = state.wakeAt - now;
+            auto slice = std::chrono::milliseconds(5); // 时间片很短，按键能立即生效
+            std::this_thread::sleep_for(remaining < slice ? remaining : slice);
+        }
+
+        runAllBackground();
+    }
+};
+
+#endif // SEQUENCE_H
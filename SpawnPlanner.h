@@ -0,0 +1,117 @@
+#ifndef SPAWNPLANNER_H
+#define SPAWNPLANNER_H
+
+#include <vector>
+#include <cstdlib>
+#include "Map.h"
+#include "Random.h"
+#include "utils.h"
+
+// 刷怪 / 放物品的位置规划
+// 原来的做法是随机试 1000 次：不检查格子上是否已经有怪物或物品，1000 次都失败时还可能返回一堵墙
+// 现在每层开始时一次性列出所有"可走、从起点能走到、没被占用"的格子，然后无放回地抽取：
+//   - 每个格子最多被检查一次，总耗时 O(格子数)，再拥挤的地图也不会卡住
+//   - 怪物之间、怪物与起点之间保持最小间距（类似泊松圆盘采样），用按间距划分的网格加速检查
+//   - 满足间距的格子用完后，退而求其次使用被间距规则拒绝过的格子；全部用完才返回 false
+class SpawnPlanner {
+private:
+    std::vector<Point> candidates; // 还没检查过的空闲格子
+    std::vector<Point> deferred;   // 因为间距被拒绝、但仍然空闲的格子
+
+    Point start{1, 1};
+    int spacing = 1;     // 怪物之间的最小切比雪夫距离
+    int safeRadius = 0;  // 怪物与起点的最小切比雪夫距离
+
+    // 加速网格：每个桶边长 = spacing，只需检查周围 3x3 个桶
+    int cellsW = 0, cellsH = 0;
+    std::vector<int> bucketHead;   // 桶 -> 第一个已放置怪物的下标，-1 表示空
+    std::vector<Point> placed;
+    std::vector<int> placedNext;   // 同一个桶里的下一个怪物
+
+    static int chebyshev(Point a, Point b) {
+        int dx = std::abs(a.x - b.x), dy = std::abs(a.y - b.y);
+        return dx > dy ? dx : dy;
+    }
+
+    // 无放回地随机取出一个格子
+    static Point takeRandom(std::vector<Point>& pool, Rng& rng) {
+        int i = rng.nextInt(static_cast<int>(pool.size()));
+        Point p = pool[i];
+        pool[i] = pool.back();
+        pool.pop_back();
+        return p;
+    }
+
+    bool farFromOthers(Point p) const {
+        int cx = p.x / spacing, cy = p.y / spacing;
+        for (int by = cy - 1; by <= cy + 1; ++by) {
+            for (int bx = cx - 1; bx <= cx + 1; ++bx) {
+                if (bx < 0 || bx >= cellsW || by < 0 || by >= cellsH) continue;
+                for (int i = bucketHead[by * cellsW + bx]; i >= 0; i = placedNext[i]) {
+                    if (chebyshev(placed[i], p) < spacing) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void place(Point p) {
+        int bucket = (p.y / spacing) * cellsW + (p.x / spacing);
+        placed.push_back(p);
+        placedNext.push_back(bucketHead[bucket]);
+        bucketHead[bucket] = static_cast<int>(placed.size()) - 1;
+    }
+
+public:
+    // 列出这一层所有可用的格子：可走、从 startPos 能走到、不是起点、不是 exitPos
+    void plan(const Map& map, Point startPos, Point exitPos, int minSpacing, int minStartDistance) {
+        start = startPos;
+        spacing = minSpacing > 0 ? minSpacing : 1;
+        safeRadius = minStartDistance;
+
+        candidates.clear();
+        deferred.clear();
+        // 【修改】和起点在同一个连通分量里的格子就是走得到的格子
+        int region = map.componentAt(start.x, start.y);
+        for (int y = 0; y < map.getHeight(); ++y) {
+            for (int x = 0; x < map.getWidth(); ++x) {
+                Point p{x, y};
+                if (region < 0 || map.componentAt(x, y) != region || p == start || p == exitPos) continue;
+                candidates.push_back(p);
+            }
+        }
+
+        cellsW = (map.getWidth() + spacing - 1) / spacing;
+        cellsH = (map.getHeight() + spacing - 1) / spacing;
+        bucketHead.assign(static_cast<size_t>(cellsW) * cellsH, -1);
+        placed.clear();
+        placedNext.clear();
+    }
+
+    // 怪物的位置：优先满足间距，实在没有时放宽；地图已满时返回 false
+    bool nextMonster(Rng& rng, Point& out) {
+        while (!candidates.empty()) {
+            Point p = takeRandom(candidates, rng);
+            if (chebyshev(p, start) >= safeRadius && farFromOthers(p)) {
+                place(p);
+                out = p;
+                return true;
+            }
+            deferred.push_back(p);
+        }
+        if (deferred.empty()) return false;
+        out = takeRandom(deferred, rng);
+        place(out);
+        return true;
+    }
+
+    // 物品的位置：任意一个还空着的格子
+    bool nextFree(Rng& rng, Point& out) {
+        std::vector<Point>& pool = candidates.empty() ? deferred : candidates;
+        if (pool.empty()) return false;
+        out = takeRandom(pool, rng);
+        return true;
+    }
+};
+
+#endif // SPAWNPLANNER_H
@@ -0,0 +1,296 @@
+#ifndef SPECTATORFEED_H
+#define SPECTATORFEED_H
+
+// 观战推流：把当前对局的画面广播给任意数量的本地观众
+// - 观众可以连接 Unix 域套接字（nc -U / socat），也可以从一个命名管道 (FIFO) 读取
+// - 新观众先收到一帧完整画面（关键帧），之后只收到变化的格子（差分帧）；
+//   玩家没有动作时连上来的观众也会立即收到最后一帧
+// - 推流在独立线程上运行，写入全部是非阻塞的：观众太慢时直接丢帧，
+//   等他的积压发完后再补一帧关键帧，永远不会拖慢玩家的回合
+#ifndef _WIN32
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "Frame.h"
+
+class SpectatorFeed : public FrameSink {
+private:
+    struct Observer {
+        int fd;
+        bool isFifo;
+        bool needsKeyframe;
+        std::string outbox; // 尚未写出的数据（最多一帧）
+    };
+
+    std::string path;
+    int listenFd = -1;
+    bool fifoMode = false;
+    int wakePipe[2] = {-1, -1};  // 游戏线程发布新帧时用来唤醒推流线程
+    std::vector<Observer> observers;
+
+    std::mutex mutex;
+    Frame pending;               // 游戏线程最新发布的画面
+    unsigned long pendingVersion = 0;
+    Frame previous;              // 上一次广播的画面，用于计算差分
+    unsigned long sentVersion = 0;
+    std::string lastKeyframe;    // previous 编码成的关键帧（用到时才编码，换帧时清空）
+
+    std::atomic<bool> stopping{false};
+    std::thread worker;
+
+    static void setNonBlocking(int fd) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    }
+
+    static void moveCursor(std::string& out, int row, int col) {
+        out += "\033[" + std::to_string(row + 1) + ";" + std::to_string(col + 1) + "H";
+    }
+
+    static void appendCell(std::string& out, const FrameCell& cell) {
+        if (cell.color == 0) {
+            out += cell.glyph;
+        } else {
+            out += Palette::code(cell.color);
+            out += cell.glyph;
+            out += Color::RESET;
+        }
+    }
+
+    static std::string encodeKeyframe(const Frame& frame) {
+        std::ostringstream ss;
+        ss << "\033[0m\033[2J\033[1;1H";
+        frame.render(ss);
+        std::string out = ss.str();
+        // 终端输出时需要 \r\n，否则观众那边的画面会错位
+        std::string fixed;
+        fixed.reserve(out.size() + frame.height + frame.lines.size());
+        for (char c : out) {
+            if (c == '\n') fixed += '\r';
+            fixed += c;
+        }
+        return fixed;
+    }
+
+    // 差分帧：只重画变化的格子；同一行连续变化的格子只移动一次光标
+    static std::string encodeDelta(const Frame& prev, const Frame& curr) {
+        std::string out;
+        for (int y = 0; y < curr.height; ++y) {
+            int lastX = -2;
+            for (int x = 0; x < curr.width; ++x) {
+                const FrameCell& cell = curr.at(x, y);
+                if (cell == prev.at(x, y)) continue;
+                if (x != lastX + 1) moveCursor(out, y, x);
+                appendCell(out, cell);
+                lastX = x;
+            }
+        }
+        for (size_t i = 0; i < curr.lines.size() || i < prev.lines.size(); ++i) {
+            const std::string empty;
+            const std::string& now = i < curr.lines.size() ? curr.lines[i] : empty;
+            const std::string& before = i < prev.lines.size() ? prev.lines[i] : empty;
+            if (now == before) continue;
+            moveCursor(out, curr.height + static_cast<int>(i), 0);
+            out += "\033[2K";
+            out += now;
+        }
+        if (!out.empty()) moveCursor(out, curr.height + static_cast<int>(curr.lines.size()), 0);
+        return out;
+    }
+
+    // 尽量写出积压数据；写不动就留着下次再写。返回 false 表示观众已断开
+    static bool drain(Observer& o) {
+        while (!o.outbox.empty()) {
+            ssize_t n = o.isFifo ? write(o.fd, o.outbox.data(), o.outbox.size())
+                                 : send(o.fd, o.outbox.data(), o.outbox.size(), MSG_NOSIGNAL);
+            if (n > 0) {
+                o.outbox.erase(0, n);
+            } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+                return true;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void acceptObservers() {
+        if (fifoMode) {
+            // FIFO 没有读者时 open 会失败（ENXIO），每次有新帧时重试
+            bool connected = false;
+            for (const auto& o : observers) connected = connected || o.isFifo;
+            if (connected) return;
+            int fd = open(path.c_str(), O_WRONLY | O_NONBLOCK);
+            if (fd >= 0) observers.push_back({fd, true, true, ""});
+            return;
+        }
+        while (true) {
+            int fd = accept(listenFd, nullptr, nullptr);
+            if (fd < 0) break;
+            setNonBlocking(fd);
+            observers.push_back({fd, false, true, ""});
+        }
+    }
+
+    // 没有新帧时，给等待关键帧、积压又已经发完的观众（例如玩家发呆时刚连上的）补发最后一帧
+    void resendLastFrame() {
+        if (sentVersion == 0) return; // 还没有画面
+        for (auto& o : observers) {
+            if (!o.needsKeyframe || !o.outbox.empty()) continue;
+            if (lastKeyframe.empty()) lastKeyframe = encodeKeyframe(previous);
+            o.outbox = lastKeyframe;
+            o.needsKeyframe = false;
+        }
+    }
+
+    void broadcast() {
+        Frame current;
+        unsigned long version;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            version = pendingVersion;
+            if (version != sentVersion) current = pending;
+        }
+        if (version == sentVersion) {
+            resendLastFrame();
+            return;
+        }
+
+        bool sameShape = current.width == previous.width && current.height == previous.height;
+        std::string delta;
+        std::string keyframe;
+        bool deltaReady = false;
+
+        for (auto& o : observers) {
+            if (!o.outbox.empty()) {
+                // 上一帧还没发完：丢掉这一帧，发完后补关键帧
+                o.needsKeyframe = true;
+                continue;
+            }
+            if (o.needsKeyframe || !sameShape) {
+                if (keyframe.empty()) keyframe = encodeKeyframe(current);
+                o.outbox = keyframe;
+                o.needsKeyframe = false;
+            } else {
+                if (!deltaReady) {
+                    delta = encodeDelta(previous, current);
+                    deltaReady = true;
+                }
+                o.outbox = delta;
+            }
+        }
+
+        previous = std::move(current);
+        sentVersion = version;
+        lastKeyframe = std::move(keyframe);
+    }
+
+    void loop() {
+        std::vector<pollfd> fds;
+        while (!stopping) {
+            fds.clear();
+            fds.push_back({wakePipe[0], POLLIN, 0});
+            if (listenFd >= 0) fds.push_back({listenFd, POLLIN, 0});
+            for (const auto& o : observers) {
+                fds.push_back({o.fd, static_cast<short>(o.outbox.empty() ? 0 : POLLOUT), 0});
+            }
+            poll(fds.data(), fds.size(), fifoMode ? 200 : 1000);
+
+            char sink[64];
+            while (read(wakePipe[0], sink, sizeof(sink)) > 0) {}
+
+            acceptObservers();
+            broadcast();
+
+            for (size_t i = 0; i < observers.size(); ) {
+                if (drain(observers[i])) {
+                    ++i;
+                } else {
+                    close(observers[i].fd);
+                    observers.erase(observers.begin() + i);
+                }
+            }
+        }
+    }
+
+public:
+    ~SpectatorFeed() {
+        stop();
+    }
+
+    // 开始推流。path 是已存在的 FIFO 时从管道输出，否则在 path 上创建 Unix 域套接字
+    bool start(const std::string& feedPath) {
+        path = feedPath;
+        struct stat st;
+        fifoMode = (stat(path.c_str(), &st) == 0 && S_ISFIFO(st.st_mode));
+        // 管道的读者退出后写入会触发 SIGPIPE，这里改成返回 EPIPE
+        if (fifoMode) signal(SIGPIPE, SIG_IGN);
+
+        if (!fifoMode) {
+            listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            if (listenFd < 0 || path.size() >= sizeof(addr.sun_path)) return false;
+            std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+            unlink(path.c_str());
+            if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+                listen(listenFd, 16) < 0) {
+                close(listenFd);
+                listenFd = -1;
+                return false;
+            }
+            setNonBlocking(listenFd);
+        }
+
+        if (pipe(wakePipe) < 0) return false;
+        setNonBlocking(wakePipe[0]);
+        setNonBlocking(wakePipe[1]);
+        worker = std::thread(&SpectatorFeed::loop, this);
+        return true;
+    }
+
+    void stop() {
+        if (!worker.joinable()) return;
+        stopping = true;
+        ssize_t ignored = write(wakePipe[1], "x", 1);
+        (void)ignored;
+        worker.join();
+        for (auto& o : observers) close(o.fd);
+        observers.clear();
+        if (listenFd >= 0) {
+            close(listenFd);
+            unlink(path.c_str());
+            listenFd = -1;
+        }
+        close(wakePipe[0]);
+        close(wakePipe[1]);
+    }
+
+    // 游戏线程调用：只做一次拷贝和一次非阻塞写，立即返回
+    void publish(const Frame& frame) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending = frame;
+            pendingVersion++;
+        }
+        ssize_t ignored = write(wakePipe[1], "x", 1);
+        (void)ignored;
+    }
+};
+
+#endif // _WIN32
+
+#endif // SPECTATORFEED_H
@@ -0,0 +1,178 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+// 工作窃取线程池
+// 每个工作线程有自己的任务队列：自己从队尾取（后进先出，缓存友好），
+// 空闲时从别人的队头偷（先进先出，偷到的往往是大块任务）
+// 【修改】parallelFor 的调用线程只执行自己那一批块，所有块都能由调用线程独自做完，所以嵌套使用不会死锁
+class ThreadPool {
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<bool> stopping{false};
+    std::atomic<int> pending{0};
+    std::atomic<unsigned> nextQueue{0};
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+
+    // 当前线程在本线程池中的编号，非工作线程为 -1
+    static int& workerIndex() {
+        static thread_local int index = -1;
+        return index;
+    }
+
+    bool popLocal(int self, std::function<void()>& task) {
+        WorkQueue& q = *queues[self];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) return false;
+        task = std::move(q.tasks.back());
+        q.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(int self, std::function<void()>& task) {
+        int n = static_cast<int>(queues.size());
+        int start = (self < 0) ? 0 : self + 1;
+        for (int k = 0; k < n; ++k) {
+            int victim = (start + k) % n;
+            if (victim == self) continue;
+            WorkQueue& q = *queues[victim];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty()) continue;
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void workerLoop(int self) {
+        workerIndex() = self;
+        while (!stopping) {
+            if (runOne()) continue;
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wakeUp.wait(lock, [this] { return stopping || pending > 0; });
+        }
+    }
+
+public:
+    // threadCount 为 0 时所有任务都在调用线程上执行（单核机器）
+    explicit ThreadPool(unsigned threadCount) {
+        unsigned queueCount = threadCount > 0 ? threadCount : 1;
+        for (unsigned i = 0; i < queueCount; ++i) {
+            queues.push_back(std::make_unique<WorkQueue>());
+        }
+        for (unsigned i = 0; i < threadCount; ++i) {
+            threads.emplace_back(&ThreadPool::workerLoop, this, static_cast<int>(i));
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 全局共享线程池：主线程之外再开 (核数 - 1) 个工作线程
+    static ThreadPool& shared() {
+        static ThreadPool pool(std::thread::hardware_concurrency() > 1
+                               ? std::thread::hardware_concurrency() - 1 : 0);
+        return pool;
+    }
+
+    int getThreadCount() const { return static_cast<int>(threads.size()); }
+
+    void submit(std::function<void()> task) {
+        int self = workerIndex();
+        int target = (self >= 0 && self < static_cast<int>(queues.size()))
+                     ? self : static_cast<int>(nextQueue++ % queues.size());
+        {
+            std::lock_guard<std::mutex> lock(queues[target]->mutex);
+            queues[target]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            pending++;
+        }
+        wakeUp.notify_one();
+    }
+
+    // 执行一个任务（先本地、后窃取），没有任务可做时返回 false
+    bool runOne() {
+        int self = workerIndex();
+        if (self >= static_cast<int>(queues.size())) self = -1;
+        std::function<void()> task;
+        if ((self >= 0 && popLocal(self, task)) || steal(self, task)) {
+            pending--;
+            task();
+            return true;
+        }
+        return false;
+    }
+
+    // 把 [0, count) 切成大小为 grain 的块并行执行 fn(i)，返回时全部完成
+    // 调用线程也参与执行，不会空等；但它只领取这一次调用自己的块，不会在等待时顺手执行池里别的任务
+    // （否则在等待怪物回合的时候，可能在同一个栈上嵌套跑起一整局别的游戏）
+    template <typename Fn>
+    void parallelFor(int count, int grain, Fn&& fn) {
+        if (count <= 0) return;
+        if (grain < 1) grain = 1;
+        int chunks = (count + grain - 1) / grain;
+        if (threads.empty() || chunks == 1) {
+            for (int i = 0; i < count; ++i) fn(i);
+            return;
+        }
+
+        // 帮手任务可能在本次调用返回之后才被取到，所以共享状态放在堆上；
+        // 那时所有块都已领完，帮手什么也不做，不会再碰 fn
+        struct Range {
+            std::atomic<int> next{0};
+            std::atomic<int> remaining;
+            int count;
+            int grain;
+            int chunks;
+        };
+        auto range = std::make_shared<Range>();
+        range->remaining = chunks;
+        range->count = count;
+        range->grain = grain;
+        range->chunks = chunks;
+        auto* body = &fn;
+        auto work = [range, body] {
+            int c;
+            while ((c = range->next++) < range->chunks) {
+                int begin = c * range->grain;
+                int end = (begin + range->grain < range->count) ? begin + range->grain : range->count;
+                for (int i = begin; i < end; ++i) (*body)(i);
+                range->remaining--;
+            }
+        };
+
+        int helpers = (chunks - 1 < getThreadCount()) ? chunks - 1 : getThreadCount();
+        for (int h = 0; h < helpers; ++h) submit(work);
+        work();
+        while (range->remaining > 0) std::this_thread::yield();
+    }
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,79 @@
+#ifndef WORLDSNAPSHOT_H
+#define WORLDSNAPSHOT_H
+
+#include <cstdint>
+#include <vector>
+#include <type_traits>
+
+// 整个可变世界的紧凑快照：地形、生物属性和位置、物品、随机数状态、回合计数
+// 全部是定长的普通数据（没有指针、没有 shared_ptr），拷贝一次就是一次 memcpy：
+//   - 调试时可以随时撤销回合（Game 里有一个快照环形缓冲）
+//   - AI 搜索可以每秒克隆 / 回滚成千上万次
+//   - 测试可以在任意回合把一局游戏"分叉"到另一个 Game 里继续跑
+// 尺寸上限与 Game::initLevel 的地图上限一致，超出时 capture 返回 false
+
+enum class CreatureKind : uint8_t { HERO, SLIME, DRAGON };
+enum class ItemKind : uint8_t { POTION, SWORD };
+
+struct CreatureRecord {
+    CreatureKind kind;
+    int16_t x, y;
+    int32_t hp, maxHp, attack, defense;
+    int32_t extra[2]; // 子类自己的状态（巨龙的行动计数、玩家的等级和经验）
+};
+
+struct ItemRecord {
+    ItemKind kind;
+    int16_t x, y;
+};
+
+struct WorldSnapshot {
+    static constexpr int MAX_WIDTH = 60;
+    static constexpr int MAX_HEIGHT = 25;
+    static constexpr int MAX_CREATURES = 256;
+    static constexpr int MAX_ITEMS = 8;
+
+    int16_t width, height;
+    int32_t level, difficulty, mode;
+    int64_t turnCount;
+    int32_t levelTurns, levelDamage;
+    uint64_t rngState;
+    int32_t creatureCount, itemCount;    // creatures[0] 一定是玩家
+    char tiles[MAX_WIDTH * MAX_HEIGHT];  // 按行排列，行宽为 width
+    CreatureRecord creatures[MAX_CREATURES];
+    ItemRecord items[MAX_ITEMS];
+};
+
+static_assert(std::is_trivially_copyable<WorldSnapshot>::value, "快照必须能直接 memcpy");
+
+// 定长环形缓冲：满了以后覆盖最旧的快照，内存只在构造时分配一次
+class SnapshotRing {
+private:
+    std::vector<WorldSnapshot> slots;
+    int head = 0;  // 下一次写入的位置
+    int count = 0;
+
+public:
+    explicit SnapshotRing(int capacity) : slots(capacity > 0 ? capacity : 1) {}
+
+    // 取一个空槽位写入新快照
+    WorldSnapshot& push() {
+        WorldSnapshot& slot = slots[head];
+        head = (head + 1) % static_cast<int>(slots.size());
+        if (count < static_cast<int>(slots.size())) count++;
+        return slot;
+    }
+
+    // 取出最近的一个快照，没有时返回 nullptr（槽位在下一次 push 之前保持有效）
+    const WorldSnapshot* pop() {
+        if (count == 0) return nullptr;
+        head = (head + static_cast<int>(slots.size()) - 1) % static_cast<int>(slots.size());
+        count--;
+        return &slots[head];
+    }
+
+    void clear() { head = count = 0; }
+    int size() const { return count; }
+};
+
+#endif // WORLDSNAPSHOT_H
@@ -1,18 +1,178 @@
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
 #include "Game.h"
+#include "GameServer.h"
+#include "SpectatorFeed.h"
+#include "BalanceRunner.h"
 
-// 静态成员定义
-std::vector<std::string> MessageLog::logs;
+// 静态成员定义（每个线程一份，见 MessageLog.h）
+thread_local std::vector<std::string> MessageLog::logs;
+
+#ifndef NO_MEMORY_TRACKING
+// 替换全局 operator new / delete，按子系统统计内存（见 MemoryStats.h）
+void* operator new(std::size_t size) {
+    void* p = Memory::trackedAlloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return Memory::trackedAlloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return Memory::trackedAlloc(size); }
+void operator delete(void* p) noexcept { Memory::trackedFree(p); }
+void operator delete[](void* p) noexcept { Memory::trackedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { Memory::trackedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { Memory::trackedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { Memory::trackedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { Memory::trackedFree(p); }
+#endif
+
+// 按层打印内存统计：每个子系统的 当前占用 / 本层峰值 / 累计分配次数（走回上一层时同一层会出现多行）
+static void printMemoryReport(const RunResult& r) {
+    std::cout << "层";
+    for (int t = 0; t < Memory::TAG_COUNT; ++t) std::cout << " | " << Memory::tagName(t) << " 占用/峰值/次数";
+    std::cout << std::endl;
+    for (size_t i = 0; i < r.levelMemory.size(); ++i) {
+        const Memory::Snapshot& m = r.levelMemory[i];
+        std::cout << r.levelVisits[i].level;
+        for (int t = 0; t < Memory::TAG_COUNT; ++t) {
+            std::cout << " | " << m.live[t] << "/" << m.peak[t] << "/" << m.allocs[t];
+        }
+        std::cout << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+#ifndef _WIN32
+    // 服务器模式：./game --server /tmp/dungeon.sock [最多同时对局数] [空闲断开秒数]
+    // 每局在连接期间独占一个工作线程，所以线程数按玩家数而不是 CPU 核数设定
+    if (argc >= 3 && std::string(argv[1]) == "--server") {
+        int sessions = (argc >= 4) ? std::atoi(argv[3]) : GameServer::DEFAULT_SESSIONS;
+        int idle = (argc >= 5) ? std::atoi(argv[4]) : GameServer::DEFAULT_IDLE_TIMEOUT;
+        GameServer server(argv[2], sessions, idle);
+        return server.run();
+    }
+#endif
+
+    // 机器人跑图：./game --bot [story|endless] [难度 1-3] [无尽模式层数上限]
+    // 不需要终端，全部输出丢弃，结束后打印一行统计
+    if (argc >= 2 && std::string(argv[1]) == "--bot") {
+        int mode = (argc >= 3 && std::string(argv[2]) == "endless") ? MODE_INFINITE : MODE_STORY;
+        int diff = (argc >= 4) ? std::atoi(argv[3]) : 2;
+        int cap = (argc >= 5) ? std::atoi(argv[4]) : 20;
+        if (diff < 1 || diff > 3) diff = 2;
+
+        NullIO headless;
+        Game game(headless);
+        auto begin = std::chrono::steady_clock::now();
+        RunResult r = game.runBot(mode, diff, mode == MODE_INFINITE ? cap : 0);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+        std::cout << (r.won ? "WIN" : r.died ? "DIED" : r.timedOut ? "TIMEOUT" : "QUIT")
+                  << " | levels: " << r.levelsCleared << " | turns: " << r.turns
+                  << " | " << ms << " ms" << std::endl;
+        return r.won ? 0 : 1;
+    }
+
+    // 内存占用报告：./game --memreport [无尽模式层数]
+    // 由机器人跑一局无尽模式，打印每一层结束时各子系统的内存统计
+    // 画面照常交给渲染线程（输出丢弃），存档照常由后台线程写入临时目录，这两部分的缓冲区也会被统计
+    // 统计是整个进程共用的：只有这样单独跑一局时数字才有意义，--server / --balance 同时跑多局时无法区分
+    if (argc >= 2 && std::string(argv[1]) == "--memreport") {
+        int levels = (argc >= 3) ? std::atoi(argv[2]) : 30;
+        std::string saveFile = (std::filesystem::temp_directory_path() / "dungeon-memreport.dat").string();
+        RunResult r;
+        {
+            NullIO headless;
+            Game game(headless);
+            game.setSeed(12345);
+            game.setMemoryTracking(true);
+            game.setSaveFile(saveFile);
+            game.setBotSaves(true);
+            game.setOffscreenRendering(true);
+            r = game.runBot(MODE_INFINITE, 2, levels);
+        }
+        std::remove(saveFile.c_str());
+        std::remove((saveFile + ".lock").c_str());
+        printMemoryReport(r);
+        return 0;
+    }
+
+    // 数值平衡模拟：./game --balance [每种配置的局数] [无尽模式层数上限] [随机种子]
+    if (argc >= 2 && std::string(argv[1]) == "--balance") {
+        int games = (argc >= 3) ? std::atoi(argv[2]) : 1000;
+        int cap = (argc >= 4) ? std::atoi(argv[3]) : 20;
+        uint64_t seed = (argc >= 5) ? std::strtoull(argv[4], nullptr, 10) : 12345;
+        auto begin = std::chrono::steady_clock::now();
+        BalanceRunner runner(games, cap, seed);
+        runner.run(std::cout);
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << "用时 " << sec << " 秒" << std::endl;
+        return 0;
+    }
+
+    // 压力测试场景：./game --scenario huge|arena [回合数]
+    //           或 ./game --scenario 宽 高 墙壁密度 史莱姆 巨龙 药水 剑 [回合数]
+    if (argc >= 3 && std::string(argv[1]) == "--scenario") {
+        ScenarioConfig config;
+        int next = 3;
+        if (std::string(argv[2]) == "huge") {
+            config = ScenarioConfig::huge();
+        } else if (std::string(argv[2]) == "arena") {
+            config = ScenarioConfig::arena();
+        } else if (argc >= 9) {
+            config.width = std::atoi(argv[2]);
+            config.height = std::atoi(argv[3]);
+            config.wallDensity = static_cast<float>(std::atof(argv[4]));
+            config.slimes = std::atoi(argv[5]);
+            config.dragons = std::atoi(argv[6]);
+            config.potions = std::atoi(argv[7]);
+            config.swords = std::atoi(argv[8]);
+            next = 9;
+        } else {
+            std::cerr << "用法: --scenario huge|arena [回合数] 或 --scenario 宽 高 墙壁密度 史莱姆 巨龙 药水 剑 [回合数]" << std::endl;
+            return 1;
+        }
+        if (argc > next) config.turns = std::atoi(argv[next]);
+        if (config.width < 5 || config.height < 5) {
+            std::cerr << "地图至少 5x5" << std::endl;
+            return 1;
+        }
+
+        NullIO headless;
+        Game game(headless);
+        game.runScenario(config).print(std::cout);
+        return 0;
+    }
 
-int main() {
     // 1. 初始化输入系统 (开启无回显模式)
     Input::init();
 
     // 2. 启动游戏
-    Game game;
+    ConsoleIO console;
+    Game game(console);
+
+#ifndef _WIN32
+    // 观战模式：./game --spectate /tmp/dungeon-watch.sock（或一个已创建的 FIFO）
+    SpectatorFeed feed;
+    if (argc >= 3 && std::string(argv[1]) == "--spectate") {
+        if (feed.start(argv[2])) game.setSpectatorFeed(&feed);
+        else std::cerr << "无法开启观战: " << argv[2] << std::endl;
+    }
+#endif
+
+    // 战斗事件日志：./game --eventlog combat.log（由后台线程追加写入）
+    FileEventLogger eventLog;
+    if (argc >= 3 && std::string(argv[1]) == "--eventlog") {
+        if (eventLog.start(argv[2])) game.addEventSink(&eventLog);
+        else std::cerr << "无法打开事件日志: " << argv[2] << std::endl;
+    }
+
     game.run();
 
     // 3. 恢复终端设置 (非常重要！否则退出后终端会乱)
     Input::restore();
 
     return 0;
-}
\ No newline at end of file
+}
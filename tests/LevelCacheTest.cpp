@@ -0,0 +1,69 @@
+#include "TestSupport.h"
+#include "LevelCache.h"
+
+// 地形压缩后再解压必须和原来一模一样，标号也要随之重建
+
+static std::vector<char> tilesOf(const Map& m) {
+    std::vector<char> out(static_cast<size_t>(m.getWidth()) * m.getHeight());
+    m.storeTiles(out.data());
+    return out;
+}
+
+static void checkRoundTrip(const Map& original) {
+    CachedLevel cached;
+    cached.compressTiles(original);
+    CHECK(cached.width == original.getWidth());
+    CHECK(cached.height == original.getHeight());
+    CHECK(cached.tiles.size() % 2 == 0);
+
+    Map restored(original.getWidth(), original.getHeight());
+    cached.decompressTiles(restored);
+    CHECK(tilesOf(restored) == tilesOf(original));
+    for (int y = 0; y < original.getHeight(); ++y) {
+        for (int x = 0; x < original.getWidth(); ++x) CHECK(restored.componentAt(x, y) == original.componentAt(x, y));
+    }
+}
+
+static void rleRoundTrip() {
+    for (uint64_t seed = 1; seed <= 30; ++seed) {
+        Map obstacles(30, 15);
+        Rng rng(seed);
+        obstacles.generateObstacles(static_cast<int>(seed % 10) + 1, rng);
+        checkRoundTrip(obstacles);
+
+        Map cave(60, 25);
+        cave.generateCave(3, rng);
+        checkRoundTrip(cave);
+    }
+
+    // 连续超过 255 格的同一种格子要拆成多段
+    Map solid(60, 25);
+    std::vector<char> walls(60 * 25, '#');
+    solid.loadTiles(walls.data(), 60, 25);
+    checkRoundTrip(solid);
+    CachedLevel cached;
+    cached.compressTiles(solid);
+    CHECK(cached.tiles.size() == 2 * ((60 * 25 + 254) / 255));
+}
+
+// 超出容量时淘汰最久没用过的一层；take 之后缓存里就没有这一层了
+static void lruEviction() {
+    LevelCache cache(2);
+    for (int level = 1; level <= 3; ++level) {
+        CachedLevel l;
+        l.level = level;
+        cache.put(std::move(l));
+    }
+    CHECK(cache.size() == 2);
+    CachedLevel out;
+    CHECK(!cache.take(1, out));
+    CHECK(cache.take(2, out) && out.level == 2);
+    CHECK(!cache.take(2, out));
+    CHECK(cache.size() == 1);
+}
+
+int main() {
+    rleRoundTrip();
+    lruEviction();
+    return testResult("LevelCacheTest");
+}
@@ -0,0 +1,85 @@
+#include <vector>
+#include "TestSupport.h"
+#include "FixedMap.h"
+#include "Map.h"
+
+// 同一个种子、同样的生成步骤必须得到同一张地图和同一套连通分量标号
+// 剧情层走 FixedMap 特化、其他层走 Map 的通用路径，两边的结果也必须一样
+
+static std::vector<char> tilesOf(const Map& m) {
+    std::vector<char> out(static_cast<size_t>(m.getWidth()) * m.getHeight());
+    m.storeTiles(out.data());
+    return out;
+}
+
+static std::vector<int> labelsOf(const Map& m) {
+    std::vector<int> out;
+    for (int y = 0; y < m.getHeight(); ++y) {
+        for (int x = 0; x < m.getWidth(); ++x) out.push_back(m.componentAt(x, y));
+    }
+    return out;
+}
+
+static void sameSeedSameMap() {
+    for (uint64_t seed = 1; seed <= 50; ++seed) {
+        for (int level = 1; level <= 8; ++level) {
+            int w = 20 + level * 2, h = 10 + level;
+            Map a(w, h), b(w, h);
+            Rng ra(seed), rb(seed);
+            a.generateObstacles(level, ra);
+            b.generateObstacles(level, rb);
+            CHECK(tilesOf(a) == tilesOf(b));
+            CHECK(labelsOf(a) == labelsOf(b));
+            CHECK(ra.getState() == rb.getState());
+
+            Map c(w, h), d(w, h);
+            Rng rc(seed), rd(seed);
+            c.generateCave(level, rc);
+            d.generateCave(level, rd);
+            CHECK(tilesOf(c) == tilesOf(d));
+            CHECK(labelsOf(c) == labelsOf(d));
+        }
+    }
+}
+
+static void fixedMapMatchesMap() {
+    for (uint64_t seed = 1; seed <= 100; ++seed) {
+        for (int level = 1; level <= 5; ++level) {
+            int w = 20 + level * 2, h = 10 + level;
+            Map fixed(w, h), generic(w, h);
+            Rng rf(seed), rg(seed);
+            CHECK(generateFixedStoryLevel(level, fixed, rf));
+            generic.generateObstacles(level, rg);
+            CHECK(tilesOf(fixed) == tilesOf(generic));
+            CHECK(labelsOf(fixed) == labelsOf(generic));
+            CHECK(rf.getState() == rg.getState());
+        }
+    }
+    Map notStory(30, 12);
+    Rng rng(1);
+    CHECK(!generateFixedStoryLevel(6, notStory, rng));
+}
+
+// 标号判断的连通性必须和真正寻路的结果一致
+static void labelsAgreeWithPathFinder() {
+    for (uint64_t seed = 1; seed <= 20; ++seed) {
+        Map m(40, 20);
+        Rng rng(seed);
+        m.generateCave(3, rng);
+        CHECK(m.isConnected({1, 1}, {m.getWidth() - 2, m.getHeight() - 2}));
+        Rng pick(seed * 7919);
+        for (int i = 0; i < 200; ++i) {
+            Point a{pick.nextInt(m.getWidth()), pick.nextInt(m.getHeight())};
+            Point b{pick.nextInt(m.getWidth()), pick.nextInt(m.getHeight())};
+            if (!m.isWalkable(a.x, a.y) || !m.isWalkable(b.x, b.y)) continue;
+            CHECK(m.isConnected(a, b) == (m.getDistance(a, b) >= 0));
+        }
+    }
+}
+
+int main() {
+    sameSeedSameMap();
+    fixedMapMatchesMap();
+    labelsAgreeWithPathFinder();
+    return testResult("MapTest");
+}
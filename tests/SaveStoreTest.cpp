@@ -0,0 +1,87 @@
+#include <filesystem>
+#include <string>
+#include <unistd.h>
+#include "TestSupport.h"
+#include "SaveStore.h"
+
+// 写入、覆盖、删除一个槽位时，其他槽位（以及别的容器）必须原封不动
+
+static SaveSlotInfo slotInfo(int slot, int level) {
+    SaveSlotInfo info;
+    info.slot = slot;
+    info.level = level;
+    info.difficulty = 2;
+    info.savedAt = 1000 + slot;
+    return info;
+}
+
+static std::string payloadFor(int slot, int version) {
+    return "slot " + std::to_string(slot) + " v" + std::to_string(version) + std::string(slot * 100, 'a' + slot);
+}
+
+static void expectPayload(SaveStore& store, int slot, const std::string& expected) {
+    std::string payload, error;
+    CHECK(store.read(slot, payload, error));
+    CHECK(error.empty());
+    CHECK(payload == expected);
+}
+
+static void expectMissing(SaveStore& store, int slot) {
+    std::string payload, error;
+    CHECK(!store.read(slot, payload, error));
+    CHECK(error.empty());
+    CHECK(!store.contains(slot));
+}
+
+static void slotIsolation(const std::string& dir) {
+    std::string path = dir + "/saves.dat";
+    std::shared_ptr<SaveStore> store = SaveStore::forPath(path);
+    CHECK(store == SaveStore::forPath(path)); // 同一个文件共用一个实例
+    CHECK(store->list().empty());
+
+    std::string error;
+    for (int slot = 1; slot <= 3; ++slot) CHECK(store->write(slotInfo(slot, slot), payloadFor(slot, 1), error));
+
+    // 覆盖 2 号、删除 3 号
+    CHECK(store->write(slotInfo(2, 9), payloadFor(2, 2), error));
+    CHECK(store->remove(3, error));
+    expectPayload(*store, 1, payloadFor(1, 1));
+    expectPayload(*store, 2, payloadFor(2, 2));
+    expectMissing(*store, 3);
+
+    std::vector<SaveSlotInfo> slots = store->list();
+    CHECK(slots.size() == 2);
+    CHECK(slots.size() == 2 && slots[0].slot == 1 && slots[0].level == 1);
+    CHECK(slots.size() == 2 && slots[1].slot == 2 && slots[1].level == 9);
+
+    // 另一个独立实例（相当于另一个进程）打开同一个文件：看到同样的内容，写入也不会冲掉对方的槽位
+    SaveStore other(path);
+    expectPayload(other, 1, payloadFor(1, 1));
+    CHECK(other.write(slotInfo(5, 5), payloadFor(5, 1), error));
+    expectPayload(*store, 5, payloadFor(5, 1));
+    expectPayload(*store, 2, payloadFor(2, 2));
+
+    // 反复覆盖同一个槽位，触发整理（重写整个文件）以后其他槽位仍然完好
+    for (int version = 3; version < 40; ++version) CHECK(store->write(slotInfo(2, version), payloadFor(2, version), error));
+    expectPayload(*store, 1, payloadFor(1, 1));
+    expectPayload(*store, 2, payloadFor(2, 39));
+    expectPayload(other, 5, payloadFor(5, 1));
+    CHECK(std::filesystem::file_size(path) < 4096);
+
+    // 别的玩家的容器互不影响
+    std::shared_ptr<SaveStore> guest = SaveStore::forPath(dir + "/guest.dat");
+    CHECK(guest != store);
+    CHECK(guest->list().empty());
+    CHECK(guest->write(slotInfo(1, 4), payloadFor(1, 7), error));
+    expectPayload(*guest, 1, payloadFor(1, 7));
+    expectPayload(*store, 1, payloadFor(1, 1));
+}
+
+int main() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path()
+                                / ("save_store_test_" + std::to_string(getpid()));
+    std::filesystem::remove_all(dir);
+    slotIsolation((dir / "saves").string()); // 目录由 SaveStore 自己创建
+    std::filesystem::remove_all(dir);
+    return testResult("SaveStoreTest");
+}
@@ -0,0 +1,81 @@
+#include <memory>
+#include "TestSupport.h"
+#include "Game.h"
+
+// 快照拍下来再恢复到另一个 Game 里，再拍一次必须得到同样的世界
+
+static void checkSame(const WorldSnapshot& a, const WorldSnapshot& b) {
+    CHECK(a.width == b.width);
+    CHECK(a.height == b.height);
+    CHECK(a.level == b.level);
+    CHECK(a.difficulty == b.difficulty);
+    CHECK(a.mode == b.mode);
+    CHECK(a.turnCount == b.turnCount);
+    CHECK(a.levelTurns == b.levelTurns);
+    CHECK(a.levelDamage == b.levelDamage);
+    CHECK(a.rngState == b.rngState);
+    CHECK(std::equal(a.tiles, a.tiles + a.width * a.height, b.tiles));
+
+    CHECK(a.creatureCount == b.creatureCount);
+    for (int i = 0; i < a.creatureCount && i < b.creatureCount; ++i) {
+        const CreatureRecord& x = a.creatures[i];
+        const CreatureRecord& y = b.creatures[i];
+        CHECK(x.kind == y.kind);
+        CHECK(x.x == y.x && x.y == y.y);
+        CHECK(x.hp == y.hp && x.maxHp == y.maxHp);
+        CHECK(x.attack == y.attack && x.defense == y.defense);
+        CHECK(x.extra[0] == y.extra[0] && x.extra[1] == y.extra[1]);
+    }
+
+    CHECK(a.itemCount == b.itemCount);
+    for (int i = 0; i < a.itemCount && i < b.itemCount; ++i) {
+        CHECK(a.items[i].kind == b.items[i].kind);
+        CHECK(a.items[i].x == b.items[i].x && a.items[i].y == b.items[i].y);
+    }
+}
+
+static void captureRestoreRoundTrip() {
+    // 快照有几十 KB，放在堆上
+    auto original = std::make_unique<WorldSnapshot>();
+    auto copy = std::make_unique<WorldSnapshot>();
+
+    NullIO ioA, ioB;
+    Game a(ioA), b(ioB);
+    CHECK(!a.captureSnapshot(*original)); // 还没有关卡
+
+    a.setSeed(42);
+    a.runBot(MODE_STORY, 2, 3);
+    CHECK(a.captureSnapshot(*original));
+
+    // 恢复到一个跑过别的局面的 Game：生物种类对不上，要重建对象
+    b.setSeed(7);
+    b.runBot(MODE_INFINITE, 1, 1);
+    b.restoreSnapshot(*original);
+    CHECK(b.captureSnapshot(*copy));
+    checkSame(*original, *copy);
+
+    // 再恢复一次：生物种类一致，走原地改写的路径
+    b.restoreSnapshot(*original);
+    CHECK(b.captureSnapshot(*copy));
+    checkSame(*original, *copy);
+}
+
+// 环形缓冲：满了覆盖最旧的，弹出按后进先出
+static void ringOrder() {
+    SnapshotRing ring(2);
+    ring.push().turnCount = 1;
+    ring.push().turnCount = 2;
+    ring.push().turnCount = 3;
+    CHECK(ring.size() == 2);
+    const WorldSnapshot* s = ring.pop();
+    CHECK(s && s->turnCount == 3);
+    s = ring.pop();
+    CHECK(s && s->turnCount == 2);
+    CHECK(ring.pop() == nullptr);
+}
+
+int main() {
+    captureRestoreRoundTrip();
+    ringOrder();
+    return testResult("SnapshotTest");
+}
@@ -0,0 +1,35 @@
+#ifndef TESTSUPPORT_H
+#define TESTSUPPORT_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "MessageLog.h"
+
+// 每个测试程序只有一个编译单元，静态成员在这里定义（main.cpp 不参与测试）
+thread_local std::vector<std::string> MessageLog::logs;
+
+namespace Test {
+    inline int failures = 0;
+}
+
+// 条件不成立时打印位置并记一次失败，继续跑后面的检查
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") 失败\n"; \
+            Test::failures++;                                                        \
+        }                                                                            \
+    } while (0)
+
+// main 的最后一行：有失败就返回 1，ctest 据此判定
+inline int testResult(const char* name) {
+    if (Test::failures == 0) {
+        std::cout << name << ": 通过" << std::endl;
+        return 0;
+    }
+    std::cerr << name << ": " << Test::failures << " 项失败" << std::endl;
+    return 1;
+}
+
+#endif // TESTSUPPORT_H